@@ -10,36 +10,96 @@ C_SRCS += \
 ../main.c \
 ../startup_ccs.c \
 ../usb_structs.c \
-../usbconfig.c 
+../usbcmd.c \
+../usbcompress.c \
+../usbconfig.c \
+../usbevent.c \
+../usbframe.c \
+../usblog.c \
+../usbpower.c \
+../usbprofile.c \
+../usbstack.c \
+../usbtelemetry.c \
+../usbuart.c 
 
 OBJS += \
 ./main.obj \
 ./startup_ccs.obj \
 ./usb_structs.obj \
-./usbconfig.obj 
+./usbcmd.obj \
+./usbcompress.obj \
+./usbconfig.obj \
+./usbevent.obj \
+./usbframe.obj \
+./usblog.obj \
+./usbpower.obj \
+./usbprofile.obj \
+./usbstack.obj \
+./usbtelemetry.obj \
+./usbuart.obj 
 
 C_DEPS += \
 ./main.pp \
 ./startup_ccs.pp \
 ./usb_structs.pp \
-./usbconfig.pp 
+./usbcmd.pp \
+./usbcompress.pp \
+./usbconfig.pp \
+./usbevent.pp \
+./usbframe.pp \
+./usblog.pp \
+./usbpower.pp \
+./usbprofile.pp \
+./usbstack.pp \
+./usbtelemetry.pp \
+./usbuart.pp 
 
 C_DEPS__QUOTED += \
 "main.pp" \
 "startup_ccs.pp" \
 "usb_structs.pp" \
-"usbconfig.pp" 
+"usbcmd.pp" \
+"usbcompress.pp" \
+"usbconfig.pp" \
+"usbevent.pp" \
+"usbframe.pp" \
+"usblog.pp" \
+"usbpower.pp" \
+"usbprofile.pp" \
+"usbstack.pp" \
+"usbtelemetry.pp" \
+"usbuart.pp" 
 
 OBJS__QUOTED += \
 "main.obj" \
 "startup_ccs.obj" \
 "usb_structs.obj" \
-"usbconfig.obj" 
+"usbcmd.obj" \
+"usbcompress.obj" \
+"usbconfig.obj" \
+"usbevent.obj" \
+"usbframe.obj" \
+"usblog.obj" \
+"usbpower.obj" \
+"usbprofile.obj" \
+"usbstack.obj" \
+"usbtelemetry.obj" \
+"usbuart.obj" 
 
 C_SRCS__QUOTED += \
 "../main.c" \
 "../startup_ccs.c" \
 "../usb_structs.c" \
-"../usbconfig.c" 
+"../usbcmd.c" \
+"../usbcompress.c" \
+"../usbconfig.c" \
+"../usbevent.c" \
+"../usbframe.c" \
+"../usblog.c" \
+"../usbpower.c" \
+"../usbprofile.c" \
+"../usbstack.c" \
+"../usbtelemetry.c" \
+"../usbuart.c" 
 
 
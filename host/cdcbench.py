@@ -0,0 +1,324 @@
+#!/usr/bin/env python3
+#
+# cdcbench.py - Measure what the virtual COM port delivers to a Linux host.
+#
+# Opens the tty in raw mode and, for each write size in the sweep, measures
+# sustained write and read throughput while the default firmware echoes the
+# data back, then the echo round trip time of single writes.  The echoed data
+# is checked against what was sent.  With --telemetry the driver counters are
+# read over endpoint 0 around each run (requires pyusb) to report receive
+# interrupts per MB and, with USB_PROFILE, the median cycles USBForward()
+# spent copying each 64 bytes of the run.  With --compress the device is
+# asked to compress the echo (USB_COMPRESS), the data sent is text that looks
+# like a log, and the stream is decoded with lz4stream.py; the report gives
+# the payload and wire rates and, with --telemetry, the time the device spent
+# compressing.  With --sim the tool runs against cdcsim.py behind a
+# pseudo-terminal instead of a board: the host build of the firmware in
+# host/sim if it has been built, else the Python model.
+#
+
+import argparse
+import os
+import select
+import sys
+import termios
+import threading
+import time
+import tty
+
+import cdcsim
+import lz4stream
+
+DEFAULT_SIZES = "1,8,64,256,1024,4096"
+
+
+def open_tty(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    # Blocking reads that return whatever has arrived.
+    attrs[6][termios.VMIN] = 1
+    attrs[6][termios.VTIME] = 0
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def pattern(offset, size):
+    return bytes((offset + i) & 0xFF for i in range(size))
+
+
+# Timestamped readings, the kind of data worth compressing.
+LOG_TEXT = b"".join(b"%10u ch%u adc=%04u temp=%u.%u ok\r\n" % (
+    n * 997, n % 4, (n * 37) % 1024, 20 + n % 3, n % 10)
+    for n in range(2048))
+
+
+def log_pattern(offset, size):
+    offset %= len(LOG_TEXT)
+    data = LOG_TEXT[offset:offset + size]
+    while len(data) < size:
+        data += LOG_TEXT[:size - len(data)]
+    return data
+
+
+def drain(fd, quiet=0.1):
+    """Discard anything still arriving from an earlier run."""
+    while select.select([fd], [], [], quiet)[0]:
+        os.read(fd, 65536)
+
+
+def read_exact(fd, size, deadline):
+    data = bytearray()
+    while len(data) < size:
+        left = deadline - time.monotonic()
+        if left <= 0 or not select.select([fd], [], [], left)[0]:
+            break
+        data += os.read(fd, size - len(data))
+    return bytes(data)
+
+
+def throughput(fd, size, duration, timeout, source=pattern, decoder=None):
+    """Write size byte chunks for duration seconds while reading the echo.
+
+    The echo is passed through decoder if one is given."""
+    result = {"written": 0, "read": 0, "wire": 0, "errors": 0}
+    done = threading.Event()
+
+    def reader():
+        offset = 0
+        while not done.is_set() or offset < result["written"]:
+            if not select.select([fd], [], [], timeout)[0]:
+                break
+            data = os.read(fd, 65536)
+            result["wire"] += len(data)
+            if decoder:
+                try:
+                    data = decoder.feed(data)
+                except lz4stream.FormatError:
+                    result["errors"] += 1
+                    break
+            if data != source(offset, len(data)):
+                result["errors"] += 1
+            offset += len(data)
+        result["read"] = offset
+        result["read_end"] = time.monotonic()
+
+    thread = threading.Thread(target=reader)
+    start = time.monotonic()
+    thread.start()
+    offset = 0
+    while time.monotonic() - start < duration:
+        chunk = source(offset, size)
+        view = memoryview(chunk)
+        while view:
+            view = view[os.write(fd, view):]
+        offset += size
+        result["written"] = offset
+    termios.tcdrain(fd)
+    write_time = time.monotonic() - start
+    done.set()
+    thread.join()
+
+    return {
+        "write_mbps": result["written"] / write_time / 1e6,
+        "read_mbps": result["read"] / (result["read_end"] - start) / 1e6,
+        "wire_mbps": result["wire"] / (result["read_end"] - start) / 1e6,
+        "seconds": result["read_end"] - start,
+        "bytes": result["written"],
+        "lost": result["written"] - result["read"],
+        "errors": result["errors"],
+    }
+
+
+def percentile(samples, percent):
+    ordered = sorted(samples)
+    index = min(len(ordered) - 1, (len(ordered) * percent + 99) // 100 - 1)
+    return ordered[max(0, index)]
+
+
+def round_trip(fd, size, rounds, timeout):
+    """Time single writes of size bytes until their echo is back."""
+    samples = []
+    failures = 0
+    for run in range(rounds):
+        chunk = pattern(run, size)
+        start = time.monotonic()
+        os.write(fd, chunk)
+        echo = read_exact(fd, size, start + timeout)
+        elapsed = time.monotonic() - start
+        if echo != chunk:
+            failures += 1
+            drain(fd)
+            continue
+        samples.append(elapsed * 1e6)
+
+    if not samples:
+        return {"failures": failures}
+    return {
+        "p50_us": percentile(samples, 50),
+        "p90_us": percentile(samples, 90),
+        "p99_us": percentile(samples, 99),
+        "max_us": max(samples),
+        "failures": failures,
+    }
+
+
+class Telemetry:
+    """Counters of the first port and the profile, read over endpoint 0."""
+
+    def __init__(self):
+        import usb.core
+        import telemetry
+
+        self.telemetry = telemetry
+        self.device = usb.core.find(idVendor=telemetry.VID,
+                                    idProduct=telemetry.PID)
+        if self.device is None:
+            sys.exit("no device for --telemetry")
+
+    def snapshot(self):
+        data = bytes(self.device.ctrl_transfer(
+            self.telemetry.REQ_TYPE_VENDOR_IN, self.telemetry.REQ_SNAPSHOT,
+            0, 0, 4096))
+        return self.telemetry.decode(data)
+
+    def irqs_per_mb(self, before, after):
+        before = before["counters"]["buffer0"]
+        after = after["counters"]["buffer0"]
+        if after["rx_bytes"] == before["rx_bytes"]:
+            return ""
+        return "%d" % ((after["rx_bursts"] - before["rx_bursts"]) * 1048576 //
+                       (after["rx_bytes"] - before["rx_bytes"]))
+
+    def copy_cycles(self, before, after):
+        """Median copy cycles per 64 bytes between two snapshots."""
+        if "profile" not in after:
+            return ""
+        before = before["profile"]["USBForward/64B"]
+        after = after["profile"]["USBForward/64B"]
+        buckets = [new - old for old, new in zip(before["buckets"],
+                                                 after["buckets"])]
+        if not sum(buckets):
+            return ""
+        return "%d" % self.telemetry.percentile(sum(buckets), after["max"],
+                                                buckets, 50)
+
+    def compress_cost(self, before, after, seconds):
+        """Compression time per KB and share of the run on the first port."""
+        before = before["counters"]["compress0"]
+        after = after["counters"]["compress0"]
+        raw = after["raw_bytes"] - before["raw_bytes"]
+        time_us = after["time_us"] - before["time_us"]
+        if not raw:
+            return "%7s %6s" % ("", "")
+        return "%7.1f %5.1f%%" % (time_us * 1024.0 / raw,
+                                  time_us / 1e4 / seconds)
+
+
+def compressed(args, fd, telemetry):
+    """Report payload and wire throughput of the compressed echo."""
+    print("%6s %12s %9s %6s %8s %6s %s" % (
+        "size", "payload MB/s", "wire MB/s", "ratio", "lost", "errors",
+        "us/KB    cpu" if telemetry else ""))
+    for size in [int(value) for value in args.sizes.split(",")]:
+        drain(fd)
+        decoder = lz4stream.Decoder()
+        before = telemetry.snapshot() if telemetry else None
+        stream = throughput(fd, size, args.duration, args.timeout,
+                            log_pattern, decoder)
+        after = telemetry.snapshot() if telemetry else None
+
+        cost = ""
+        if telemetry:
+            cost = telemetry.compress_cost(before, after, stream["seconds"])
+        ratio = (float(decoder.coded_bytes) / decoder.raw_bytes
+                 if decoder.raw_bytes else 0.0)
+        print("%6d %12.3f %9.3f %6.2f %8d %6d %s" % (
+            size, stream["read_mbps"], stream["wire_mbps"], ratio,
+            stream["lost"], stream["errors"], cost))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Throughput and latency of the CDC virtual COM port.")
+    parser.add_argument("tty", nargs="?", help="tty device, e.g. /dev/ttyACM0")
+    parser.add_argument("--sim", action="store_true",
+                        help="run against cdcsim.py instead of a board")
+    parser.add_argument("--sizes", default=DEFAULT_SIZES,
+                        help="comma separated write sizes (default %s)" %
+                             DEFAULT_SIZES)
+    parser.add_argument("--duration", type=float, default=2.0,
+                        help="seconds of streaming per size (default 2)")
+    parser.add_argument("--rounds", type=int, default=200,
+                        help="round trips per size (default 200)")
+    parser.add_argument("--timeout", type=float, default=1.0,
+                        help="seconds to wait for echoed data (default 1)")
+    parser.add_argument("--telemetry", action="store_true",
+                        help="report receive interrupts per MB and copy "
+                             "cycles per 64 bytes")
+    parser.add_argument("--compress", action="store_true",
+                        help="measure the compressed echo instead")
+    args = parser.parse_args()
+
+    sim = None
+    if args.sim:
+        sim = cdcsim.open_sim(compress=args.compress).start()
+        path = sim.name
+    elif args.tty:
+        path = args.tty
+    else:
+        parser.error("give a tty or --sim")
+
+    telemetry = Telemetry() if args.telemetry else None
+    fd = open_tty(path)
+    if args.compress and not sim:
+        device = telemetry.device if telemetry else None
+        if device is None:
+            import usb.core
+            device = usb.core.find(idVendor=lz4stream.VID,
+                                   idProduct=lz4stream.PID)
+            if device is None:
+                sys.exit("no device for --compress")
+        # Nothing may be on its way while the mode changes.
+        drain(fd)
+        lz4stream.enable(device, True)
+    try:
+        if args.compress:
+            compressed(args, fd, telemetry)
+            return
+        print("%6s %10s %10s %8s %6s %9s %9s %9s %9s %s" % (
+            "size", "write MB/s", "read MB/s", "lost", "errors",
+            "rtt p50", "rtt p90", "rtt p99", "rtt max",
+            "irqs/MB cyc/64B" if telemetry else ""))
+        for size in [int(value) for value in args.sizes.split(",")]:
+            drain(fd)
+            before = telemetry.snapshot() if telemetry else None
+            stream = throughput(fd, size, args.duration, args.timeout)
+            after = telemetry.snapshot() if telemetry else None
+            drain(fd)
+            rtt = round_trip(fd, size, args.rounds, args.timeout)
+
+            counters = ""
+            if telemetry:
+                counters = "%7s %7s" % (
+                    telemetry.irqs_per_mb(before, after),
+                    telemetry.copy_cycles(before, after))
+            if "p50_us" in rtt:
+                times = "%9.0f %9.0f %9.0f %9.0f" % (
+                    rtt["p50_us"], rtt["p90_us"], rtt["p99_us"],
+                    rtt["max_us"])
+            else:
+                times = "%9s %9s %9s %9s" % ("-", "-", "-", "-")
+            print("%6d %10.3f %10.3f %8d %6d %s %s" % (
+                size, stream["write_mbps"], stream["read_mbps"],
+                stream["lost"], stream["errors"] + rtt["failures"], times,
+                counters))
+    finally:
+        os.close(fd)
+        if sim:
+            sim.stop()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# cdcsim.py - Stand-in for the board behind a pseudo-terminal.
+#
+# By default this runs the host build of the firmware, host/sim/cdcpty (see
+# host/sim/Makefile), which is the real driver code of usbconfig.c and the
+# echo of main.c behind a pseudo-terminal.  Build it with make in host/sim.
+# Where it has not been built, or with --model, a Python model of what the
+# default firmware does with the data is used instead: it is echoed back
+# (USBForward() in main.c) through a transmit buffer that only sends full 64
+# byte packets until the latency timer runs out (see "Latency Timer" in the
+# README).  The receive side stops reading once the transmit buffer is full,
+# like the OUT endpoint NAKing the host.  This lets cdcbench.py and other host
+# tools run on a machine with no board attached; the numbers it gives
+# describe the host side and the driver as run on the host, not the board.
+# With compress set the echo is sent as the compressed stream of
+# USB_COMPRESS, as if the host had switched it on (see lz4stream.py), by
+# host/sim/cdcpty-compress or the model.
+#
+
+import argparse
+import os
+import select
+import subprocess
+import termios
+import threading
+import time
+import tty
+
+import lz4stream
+
+PACKET = 64
+
+SIM_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "sim")
+
+
+class CDCSim:
+    def __init__(self, latency_ms=16, buffer_size=256, compress=False):
+        self.latency = latency_ms / 1000.0
+        self.buffer_size = buffer_size
+        self.compress = compress
+        self._block = bytearray()
+        self.master, self.slave = os.openpty()
+        tty.setraw(self.slave)
+        # Keep the master side free of line discipline processing as well.
+        attrs = termios.tcgetattr(self.master)
+        attrs[3] &= ~termios.ECHO
+        termios.tcsetattr(self.master, termios.TCSANOW, attrs)
+        self.name = os.ttyname(self.slave)
+        self._stop = threading.Event()
+        self._thread = threading.Thread(target=self._run, daemon=True)
+
+    def start(self):
+        self._thread.start()
+        return self
+
+    def stop(self):
+        self._stop.set()
+        self._thread.join()
+        os.close(self.master)
+        os.close(self.slave)
+
+    def _code(self, data):
+        """Pass data through the compressor like USBCompressForward()."""
+        if not self.compress:
+            return data
+        self._block += data
+        size = len(self._block)
+        # Full blocks go at once, a partial one once nothing else is waiting.
+        if select.select([self.master], [], [], 0)[0]:
+            size -= size % lz4stream.BLOCK_SIZE
+        coded = lz4stream.encode(bytes(self._block[:size]))
+        del self._block[:size]
+        return coded
+
+    def _run(self):
+        pending = bytearray()
+        oldest = None
+        while not self._stop.is_set():
+            # Full packets go at once, a short one once it has waited for
+            # the latency timer.
+            timeout = 0.05
+            ready = len(pending) >= PACKET
+            if pending and not ready:
+                left = oldest + self.latency - time.monotonic()
+                ready = left <= 0
+                if not ready:
+                    timeout = left
+            want_read = len(pending) < self.buffer_size
+            readable, writable, _ = select.select(
+                [self.master] if want_read else [],
+                [self.master] if ready else [], [], timeout)
+
+            if readable:
+                data = self._code(os.read(self.master,
+                                          self.buffer_size - len(pending)))
+                if data and not pending:
+                    oldest = time.monotonic()
+                pending += data
+
+            if writable:
+                count = len(pending)
+                if count >= PACKET:
+                    count -= count % PACKET
+                sent = os.write(self.master, bytes(pending[:count]))
+                del pending[:sent]
+                oldest = time.monotonic() if pending else None
+
+
+class CDCPty:
+    """The host build of the firmware behind its own pseudo-terminal."""
+
+    def __init__(self, compress=False):
+        self.path = os.path.join(SIM_DIR,
+                                 "cdcpty-compress" if compress else "cdcpty")
+        self.name = None
+        self._process = None
+
+    def start(self):
+        self._process = subprocess.Popen([self.path], stdout=subprocess.PIPE)
+        self.name = self._process.stdout.readline().decode().strip()
+        if not self.name:
+            self._process.wait()
+            raise OSError("%s did not start" % self.path)
+        return self
+
+    def stop(self):
+        self._process.terminate()
+        self._process.wait()
+        self._process.stdout.close()
+
+
+def open_sim(compress=False, model=False, latency_ms=16, buffer_size=256):
+    """Return the host build of the firmware if it has been built, else the
+    model.  The latency and buffer size only apply to the model; the build
+    has those of the firmware."""
+    sim = CDCPty(compress)
+    if not model and os.access(sim.path, os.X_OK):
+        return sim
+    return CDCSim(latency_ms, buffer_size, compress)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Run the CDC firmware behind a pseudo-terminal.")
+    parser.add_argument("--model", action="store_true",
+                        help="use the Python model rather than host/sim/cdcpty")
+    parser.add_argument("--latency", type=int, default=16,
+                        help="latency timer of the model in ms (default 16)")
+    parser.add_argument("--buffer", type=int, default=256,
+                        help="transmit buffer size of the model in bytes "
+                             "(default 256)")
+    parser.add_argument("--compress", action="store_true",
+                        help="send the echo compressed")
+    args = parser.parse_args()
+
+    sim = open_sim(args.compress, args.model, args.latency,
+                   args.buffer).start()
+    print(sim.name, flush=True)
+    try:
+        while True:
+            time.sleep(1)
+    except KeyboardInterrupt:
+        pass
+    sim.stop()
+
+
+if __name__ == "__main__":
+    main()
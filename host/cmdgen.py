@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# cmdgen.py - Generate the perfect-hash command table used by usbcmd.c.
+#
+# Each argument is NAME:HANDLER.  A seed is searched for so that the FNV-1a
+# hash of every command name lands in a different slot of the smallest
+# power-of-two table that works, then usbcmd_table.h is written to stdout:
+#
+#     host/cmdgen.py help:USBCmdHelp ping:CmdPing > usbcmd_table.h
+#
+# The hash must match CmdHash() in usbcmd.c.
+#
+
+import sys
+
+FNV_PRIME = 0x01000193
+FNV_OFFSET = 0x811C9DC5
+MAX_BITS = 8
+MAX_TRIES = 100000
+
+
+def cmd_hash(name, seed, bits):
+    h = seed
+    for c in name.encode("ascii"):
+        h = ((h ^ c) * FNV_PRIME) & 0xFFFFFFFF
+    return h >> (32 - bits)
+
+
+def find_seed(names):
+    bits = max(1, (len(names) - 1).bit_length())
+    while bits <= MAX_BITS:
+        for i in range(MAX_TRIES):
+            seed = (FNV_OFFSET + i) & 0xFFFFFFFF
+            slots = {cmd_hash(n, seed, bits) for n in names}
+            if len(slots) == len(names):
+                return seed, bits
+        bits += 1
+    sys.exit("cmdgen.py: no perfect hash found")
+
+
+def main():
+    cmds = []
+    for arg in sys.argv[1:]:
+        name, sep, handler = arg.partition(":")
+        if not sep or not name or not handler or " " in name:
+            sys.exit("cmdgen.py: bad command '%s', expected NAME:HANDLER" % arg)
+        cmds.append((name, handler))
+    if not cmds or len({n for n, _ in cmds}) != len(cmds):
+        sys.exit("cmdgen.py: need a list of distinct commands")
+
+    seed, bits = find_seed([n for n, _ in cmds])
+    table = [None] * (1 << bits)
+    for name, handler in cmds:
+        table[cmd_hash(name, seed, bits)] = (name, handler)
+
+    out = sys.stdout
+    out.write("/*\n * usbcmd_table.h\n *\n"
+              " * Generated by host/cmdgen.py %s\n"
+              " * Do not edit; rerun the command above instead.\n */\n\n"
+              % " ".join(sys.argv[1:]))
+    out.write("#ifndef USBCMD_TABLE_H_\n#define USBCMD_TABLE_H_\n\n")
+    for handler in sorted({h for _, h in cmds if h != "USBCmdHelp"}):
+        out.write("extern void %s(tUSBCmdReply *psReply, const char *pcArgs,\n"
+                  "        uint32_t ui32ArgsLen);\n" % handler)
+    out.write("\n#define USB_CMD_HASH_BITS       %d\n" % bits)
+    out.write("#define USB_CMD_HASH_SEED       0x%08X\n\n" % seed)
+    out.write("static const tUSBCmd g_psUSBCmdTable[1 << USB_CMD_HASH_BITS] =\n{\n")
+    for entry in table:
+        if entry:
+            out.write('    { "%s", %d, %s },\n' % (entry[0], len(entry[0]),
+                                                  entry[1]))
+        else:
+            out.write("    { 0, 0, 0 },\n")
+    out.write("};\n\n#endif /* USBCMD_TABLE_H_ */\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+#
+# logdecode.py - Turn the driver's binary log back into text.
+#
+# The device records each message as a number and its raw arguments (see
+# usblog.h).  This reads the records either from the device, over the
+# USB_TELEMETRY_REQ_LOG vendor request, or from a file holding a copy of the
+# log ring taken with the debugger, and prints them using the format strings
+# from usblog.h.  Reading from the device requires pyusb.
+#
+
+import argparse
+import os
+import re
+import struct
+import sys
+import time
+
+VID = 0x1CBE
+PID = 0x0002
+
+REQ_LOG = 0x03
+REQ_TYPE_VENDOR_IN = 0xC0
+
+# Must match tUSBLogRecord and USB_LOG_READ_MAX in usblog.h.
+RECORD = struct.Struct("<6I")
+READ_MAX = 16
+
+# Must match USB_TICK_RATE in usbconfig.h and the system clock set in main.c.
+TICK_RATE = 1000
+CLOCK_HZ = 50000000
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir,
+                      "usblog.h")
+MESSAGE = re.compile(r'MSG\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+CONVERSION = re.compile(r"%[-+ #0]*\d*[cdux]")
+
+
+def load_formats(path):
+    with open(path) as header:
+        text = header.read()
+    return [(name, fmt.encode().decode("unicode_escape"))
+            for name, fmt in MESSAGE.findall(text)]
+
+
+def format_record(formats, time_us, msg, args):
+    if msg >= len(formats):
+        return "%10u message %u %x %x" % (time_us, msg, args[0], args[1])
+    fmt = formats[msg][1]
+    used = len(CONVERSION.findall(fmt))
+    return "%10u %s" % (time_us, fmt % args[:used])
+
+
+def record_time(ticks, count, clock):
+    """Microseconds from the tick count and SysTick value, as USBTimeToUs()
+    works them out but without wrapping after 71 minutes."""
+    period = clock // TICK_RATE
+    return (ticks * (1000000 // TICK_RATE) +
+            (period - 1 - count) // (clock // 1000000))
+
+
+def decode(data, clock):
+    """Return (sequence, time, message, args) for every complete record."""
+    records = []
+    for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        seq, ticks, count, msg, arg0, arg1 = RECORD.unpack_from(data, offset)
+        if seq:
+            records.append((seq - 1, record_time(ticks, count, clock), msg,
+                            (arg0, arg1)))
+    return records
+
+
+def print_records(formats, records, expected):
+    for seq, time_us, msg, args in records:
+        if expected is not None and seq != expected:
+            print("(%u lost)" % ((seq - expected) & 0xFFFFFFFF))
+        print(format_record(formats, time_us, msg, args))
+        expected = (seq + 1) & 0xFFFFFFFF
+    return expected
+
+
+def poll(formats, interval, clock):
+    import usb.core
+
+    device = usb.core.find(idVendor=VID, idProduct=PID)
+    if device is None:
+        sys.exit("device %04x:%04x not found" % (VID, PID))
+
+    # Start from the oldest record the device still has.
+    seq = 0
+    expected = None
+    while True:
+        data = bytes(device.ctrl_transfer(REQ_TYPE_VENDOR_IN, REQ_LOG,
+                                          seq & 0xFFFF, seq >> 16,
+                                          READ_MAX * RECORD.size))
+        records = decode(data, clock)
+        if not records:
+            if interval is None:
+                return
+            time.sleep(interval)
+            continue
+        expected = print_records(formats, records, expected)
+        seq = expected
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode the CDC driver's binary log.")
+    parser.add_argument("--file",
+                        help="decode a dump of the log ring instead of "
+                             "reading the device")
+    parser.add_argument("--follow", type=float, metavar="SECONDS",
+                        help="keep polling the device at this interval")
+    parser.add_argument("--header", default=HEADER,
+                        help="usblog.h to take the messages from")
+    parser.add_argument("--clock", type=int, default=CLOCK_HZ, metavar="HZ",
+                        help="the device's system clock (default %(default)d)")
+    args = parser.parse_args()
+
+    formats = load_formats(args.header)
+    if not formats:
+        sys.exit("no messages found in %s" % args.header)
+
+    if args.file:
+        with open(args.file, "rb") as dump:
+            records = sorted(decode(dump.read(), args.clock))
+        print_records(formats, records, None)
+    else:
+        poll(formats, args.follow, args.clock)
+
+
+if __name__ == "__main__":
+    main()
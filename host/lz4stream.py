@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+#
+# lz4stream.py - Decode the compressed stream of a port (see usbcompress.h).
+#
+# Once the host has switched compression on, everything the port sends is a
+# sequence of blocks, each a four byte header of two little-endian 16-bit
+# words, the size of the data and the size of what follows, and then either
+# the data itself (USB_COMPRESS_STORED set in the second word) or an LZ4
+# block.  Decoder takes the stream in pieces of any size, as read from the
+# tty, and returns the data of every block completed so far.  compress_block()
+# is the firmware's coder, for tests and the simulator.  Run on its own, this
+# decodes a capture of the stream from a file or stdin.
+#
+# The request that switches it on, USB_TELEMETRY_REQ_COMPRESS, goes to the
+# device over endpoint 0 (requires pyusb, see enable()).
+#
+
+import argparse
+import struct
+import sys
+
+VID = 0x1CBE
+PID = 0x0002
+
+REQ_COMPRESS = 0x04
+REQ_TYPE_VENDOR_IN = 0xC0
+REQ_TYPE_VENDOR_OUT = 0x40
+
+# Must match usbcompress.h.
+HEADER = struct.Struct("<HH")
+STORED = 0x8000
+BLOCK_SIZE = 256
+HASH_BITS = 8
+
+MIN_MATCH = 4
+MF_LIMIT = 12
+LAST_LITERALS = 5
+
+
+class FormatError(Exception):
+    pass
+
+
+def _length(data, pos, value):
+    """Add the extension bytes of an LZ4 length that starts at value 15."""
+    if value != 15:
+        return value, pos
+    while True:
+        if pos >= len(data):
+            raise FormatError("length runs past the block")
+        extra = data[pos]
+        pos += 1
+        value += extra
+        if extra != 255:
+            return value, pos
+
+
+def decompress_block(data, size):
+    """Decode one LZ4 block that decodes to size bytes."""
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        literals, pos = _length(data, pos, token >> 4)
+        if pos + literals > len(data):
+            raise FormatError("literals run past the block")
+        out += data[pos:pos + literals]
+        pos += literals
+        if pos == len(data):
+            break
+
+        if pos + 2 > len(data):
+            raise FormatError("offset runs past the block")
+        offset = data[pos] | (data[pos + 1] << 8)
+        pos += 2
+        match, pos = _length(data, pos, token & 0x0F)
+        match += MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise FormatError("offset %d out of range" % offset)
+        start = len(out) - offset
+        for index in range(match):
+            out.append(out[start + index])
+
+    if len(out) != size:
+        raise FormatError("block decoded to %d bytes, not %d" %
+                          (len(out), size))
+    return bytes(out)
+
+
+def _length_bytes(value):
+    out = bytearray()
+    value -= 15
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+    return out
+
+
+def _sequence(literals, offset, match):
+    token = min(len(literals), 15) << 4
+    out = bytearray()
+    if len(literals) >= 15:
+        out += _length_bytes(len(literals))
+    out += literals
+    if match:
+        out += struct.pack("<H", offset)
+        match -= MIN_MATCH
+        token |= min(match, 15)
+        if match >= 15:
+            out += _length_bytes(match)
+    return bytes([token]) + bytes(out)
+
+
+def _hash(word):
+    return ((word * 2654435761) & 0xFFFFFFFF) >> (32 - HASH_BITS)
+
+
+def compress_block(data):
+    """Code data the way BlockCode() in usbcompress.c does."""
+    table = [0] * (1 << HASH_BITS)
+    out = bytearray()
+    pos = anchor = 0
+    while pos + MF_LIMIT <= len(data):
+        word = struct.unpack_from("<I", data, pos)[0]
+        slot = _hash(word)
+        candidate = table[slot]
+        table[slot] = pos
+        if candidate >= pos or data[candidate:candidate + 4] != \
+                data[pos:pos + 4]:
+            pos += 1
+            continue
+
+        match = MIN_MATCH
+        while pos + match < len(data) - LAST_LITERALS and \
+                data[candidate + match] == data[pos + match]:
+            match += 1
+        out += _sequence(data[anchor:pos], pos - candidate, match)
+        pos += match
+        anchor = pos
+    out += _sequence(data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def encode(data, block_size=BLOCK_SIZE):
+    """The stream the firmware sends for data, cut into full blocks."""
+    out = bytearray()
+    for start in range(0, len(data), block_size):
+        block = data[start:start + block_size]
+        coded = compress_block(block)
+        if len(coded) >= len(block):
+            out += HEADER.pack(len(block), len(block) | STORED) + block
+        else:
+            out += HEADER.pack(len(block), len(coded)) + coded
+    return bytes(out)
+
+
+class Decoder:
+    """Turns the compressed stream back into data, a piece at a time."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.raw_bytes = 0
+        self.coded_bytes = 0
+        self.blocks = 0
+
+    def feed(self, data):
+        self.pending += data
+        out = bytearray()
+        while len(self.pending) >= HEADER.size:
+            size, coded = HEADER.unpack_from(self.pending)
+            stored = coded & STORED
+            coded &= ~STORED
+            end = HEADER.size + coded
+            if len(self.pending) < end:
+                break
+            body = bytes(self.pending[HEADER.size:end])
+            if stored:
+                if coded != size:
+                    raise FormatError("stored block of %d bytes holds %d" %
+                                      (size, coded))
+                out += body
+            else:
+                out += decompress_block(body, size)
+            del self.pending[:end]
+            self.raw_bytes += size
+            self.coded_bytes += end
+            self.blocks += 1
+        return bytes(out)
+
+
+def enable(device, on, port=0):
+    """Switch compression of a port on or off and return the block size."""
+    device.ctrl_transfer(REQ_TYPE_VENDOR_OUT, REQ_COMPRESS, 1 if on else 0,
+                         port)
+    reply = bytes(device.ctrl_transfer(REQ_TYPE_VENDOR_IN, REQ_COMPRESS, 0,
+                                       port, 4))
+    enabled, block_size = struct.unpack("<HH", reply)
+    if enabled != (1 if on else 0):
+        raise IOError("device did not take the request")
+    return block_size
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Decode a capture of a port's compressed stream.")
+    parser.add_argument("file", nargs="?",
+                        help="capture to decode (default stdin)")
+    args = parser.parse_args()
+
+    source = open(args.file, "rb") if args.file else sys.stdin.buffer
+    decoder = Decoder()
+    with source:
+        while True:
+            data = source.read(65536)
+            if not data:
+                break
+            sys.stdout.buffer.write(decoder.feed(data))
+    if decoder.pending:
+        sys.exit("%d bytes of an incomplete block left over" %
+                 len(decoder.pending))
+    if decoder.raw_bytes:
+        print("%d blocks, %d bytes from %d (%.1f%%)" % (
+            decoder.blocks, decoder.raw_bytes, decoder.coded_bytes,
+            100.0 * decoder.coded_bytes / decoder.raw_bytes), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
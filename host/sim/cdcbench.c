@@ -0,0 +1,508 @@
+/*
+ * cdcbench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Echo benchmark for the host simulation.  The firmware is run unchanged as
+// the echo application: the bench plays the USB host, sending a patterned
+// stream to port 0 in 64-byte packets with a number of them in flight and
+// collecting the echo.  Every packet the device receives goes through
+// RxHandler() and the receive buffer, is forwarded by the main loop and comes
+// back through the transmit buffer and TxPacketWrite().
+//
+// Reported are the throughput over the time spent in the firmware, that is
+// with the bench's own time taken out, the round trip of each packet from
+// being sent to its last byte coming back, the packets the device NAKed and
+// any data lost or corrupted.  Run with -h for the options.
+//
+// By default the host is as fast as the simulation can go, which measures
+// the firmware's own cost.  With -b the bench runs on a virtual clock against
+// a model of the full-speed bus instead, to show how the firmware keeps the
+// bus busy.  The bus carries one transaction at a time: a 64-byte bulk
+// transaction takes a nineteenth of a 1 ms frame, the most the bus fits, and
+// an IN the device NAKs a short slot.  The host alternates between the OUT
+// and IN endpoints.  Whatever the firmware does between two calls of the idle
+// hook is taken to keep the Cortex-M4 busy for the host time it took times
+// the -c scale, and interrupts are held off until then while the bus carries
+// on.  The scale is an assumption, not a measurement: the default of 100
+// puts the echo at a few thousand cycles a packet at 50 MHz.
+//
+// Built with USB_COMMANDS the stream is "ping" commands instead, and the
+// bench checks every "pong" and reports the commands handled per second.
+//
+// Built as a UART bridge the firmware echoes through the simulated UART,
+// whose TX line is looped back to its RX line; -r sets its baud rate with
+// SET_LINE_CODING before the stream starts.  The UART then runs on a
+// virtual clock that moves on a bit time at every call of the idle
+// hook, so the firmware always keeps up with the line however the host
+// schedules the simulation.  The firmware time and the interrupts taken are
+// reported per KB, to compare feeding the UART from the CPU against feeding
+// it with the uDMA controller.  This does not combine with -b, as the
+// processor time the bus model charges for the simulated UART's own work
+// would overrun the RX FIFO.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/hw_ints.h"
+#include "hostsim.h"
+#ifdef USB_PROFILE
+#include "usbprofile.h"
+#endif
+
+#define PACKET_SIZE             64
+
+// Give up once nothing has moved for this long.
+#define STALL_NS                1000000000ULL
+
+// Bus time of a bulk transaction carrying data, accepted or NAKed, and of an
+// IN the device NAKs or answers with a zero-length packet.
+#define BUS_DATA_NS             (1000000 / 19)
+#define BUS_SHORT_NS            7000
+
+extern int FirmwareMain(void);
+
+static uint32_t g_ui32Bytes = 16 * 1024 * 1024;
+static uint32_t g_ui32Window = 4;
+static uint32_t g_ui32PacketSize = PACKET_SIZE;
+static bool g_bBus;
+static uint32_t g_ui32CPUScale = 100;
+static uint32_t g_ui32Baud;
+
+// Progress of the run.
+static bool g_bConfigured;
+static uint32_t g_ui32Sent;
+static uint32_t g_ui32Received;
+static uint32_t g_ui32PacketsSent;
+static uint32_t g_ui32PacketsDone;
+static uint32_t g_ui32NAKs;
+static uint32_t g_ui32Mismatches;
+static uint64_t g_ui64LastProgress;
+static uint64_t g_ui64FirmwareStart;
+static uint64_t g_ui64Start;
+
+// The bus model: the virtual time the bus is free and the simulated
+// processor done, the host time in the firmware at the end of the last idle
+// hook, the processor's busy time in all and the endpoint to try first.
+static uint64_t g_ui64BusNs;
+static uint64_t g_ui64FirmwareMark;
+static uint64_t g_ui64CPUNs;
+static uint64_t g_ui64HostAvgNs;
+static uint32_t g_ui32INNAKs;
+static bool g_bPreferIN;
+
+// The time each packet was sent, then its round trip.
+static uint64_t *g_pui64Latency;
+
+#ifdef USB_COMMANDS
+// Built with the command interpreter the stream is a "ping" command line
+// after another, each answered by a line of the same length.
+#define COMMAND_SIZE            6
+
+static uint8_t Pattern(uint32_t ui32Offset)
+{
+    return((uint8_t)"ping\r\n"[ui32Offset % COMMAND_SIZE]);
+}
+
+static uint8_t Expected(uint32_t ui32Offset)
+{
+    return((uint8_t)"pong\r\n"[ui32Offset % COMMAND_SIZE]);
+}
+#else
+static uint8_t Pattern(uint32_t ui32Offset)
+{
+    return((uint8_t)((ui32Offset * 7) + (ui32Offset >> 8)));
+}
+
+#define Expected(ui32Offset)    Pattern(ui32Offset)
+#endif
+
+// Collect one packet of the echo.  Returns its size, or -1 if the device
+// NAKed.
+static int32_t EchoCollect(void)
+{
+    uint8_t pui8Packet[PACKET_SIZE];
+    uint32_t ui32Idx, ui32Done;
+    int32_t i32Size;
+    uint64_t ui64Now;
+
+    i32Size = HostSimUSBIn(0, pui8Packet);
+    if(i32Size < 0)
+    {
+        return(i32Size);
+    }
+
+    ui64Now = HostSimTimeNs();
+    for(ui32Idx = 0; ui32Idx < (uint32_t)i32Size; ui32Idx++)
+    {
+        if(pui8Packet[ui32Idx] != Expected(g_ui32Received + ui32Idx))
+        {
+            g_ui32Mismatches++;
+        }
+    }
+    g_ui32Received += i32Size;
+    g_ui64LastProgress = ui64Now;
+
+    // Every packet whose last byte is now back has made the trip.
+    ui32Done = g_ui32Received / g_ui32PacketSize;
+    while(g_ui32PacketsDone < ui32Done)
+    {
+        g_pui64Latency[g_ui32PacketsDone] =
+            ui64Now - g_pui64Latency[g_ui32PacketsDone];
+        g_ui32PacketsDone++;
+    }
+    return(i32Size);
+}
+
+// Whether the window lets another packet be sent.
+static bool EchoCanSend(void)
+{
+    return((g_ui32Sent < g_ui32Bytes) &&
+           ((g_ui32PacketsSent - g_ui32PacketsDone) < g_ui32Window));
+}
+
+// Send the next packet of the stream.  Returns false if the device NAKed.
+static bool EchoSend(void)
+{
+    uint8_t pui8Packet[PACKET_SIZE];
+    uint32_t ui32Idx, ui32Size;
+
+    ui32Size = g_ui32Bytes - g_ui32Sent;
+    if(ui32Size > g_ui32PacketSize)
+    {
+        ui32Size = g_ui32PacketSize;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32Size; ui32Idx++)
+    {
+        pui8Packet[ui32Idx] = Pattern(g_ui32Sent + ui32Idx);
+    }
+    g_pui64Latency[g_ui32PacketsSent] = HostSimTimeNs();
+    if(!HostSimUSBOut(0, pui8Packet, ui32Size))
+    {
+        g_ui32NAKs++;
+        return(false);
+    }
+    g_ui32Sent += ui32Size;
+    g_ui32PacketsSent++;
+    g_ui64LastProgress = HostSimTimeNs();
+    return(true);
+}
+
+// Run one transaction on the bus and move the bus time on.
+static void BusTransaction(void)
+{
+    int32_t i32Size;
+
+    HostSimTimeSet(g_ui64BusNs);
+    if(EchoCanSend() && !g_bPreferIN)
+    {
+        EchoSend();
+        g_ui64BusNs += BUS_DATA_NS;
+    }
+    else
+    {
+        i32Size = EchoCollect();
+        if(i32Size < 0)
+        {
+            g_ui32INNAKs++;
+        }
+        g_ui64BusNs += (i32Size > 0) ? BUS_DATA_NS : BUS_SHORT_NS;
+    }
+    g_bPreferIN = !g_bPreferIN;
+}
+
+// The idle hook with the bus model.  What the firmware has done since the
+// last call keeps the processor busy for a while; the bus carries on
+// meanwhile with the interrupts it raises held off.
+static bool BusIdle(void)
+{
+    uint64_t ui64HostNs, ui64CPUNs;
+
+    // The host may have been busy with something else in the middle, which
+    // would stall the simulated processor for that time times the scale.
+    // Anything over four times the running average is taken as that and cut
+    // down to it.
+    ui64HostNs = HostSimFirmwareNs() - g_ui64FirmwareMark;
+    if(g_ui64HostAvgNs && (ui64HostNs > (4 * g_ui64HostAvgNs)))
+    {
+        ui64HostNs = 4 * g_ui64HostAvgNs;
+    }
+    g_ui64HostAvgNs = g_ui64HostAvgNs ?
+                      ((g_ui64HostAvgNs * 15) + ui64HostNs) / 16 : ui64HostNs;
+
+    ui64CPUNs = ui64HostNs * g_ui32CPUScale;
+    g_ui64CPUNs += ui64CPUNs;
+    ui64CPUNs += HostSimTimeNs();
+
+    HostSimHold(true);
+    do
+    {
+        BusTransaction();
+    }
+    while(g_ui64BusNs < ui64CPUNs);
+    HostSimTimeSet(g_ui64BusNs);
+
+    g_ui64FirmwareMark = HostSimFirmwareNs();
+    HostSimHold(false);
+
+    if(g_ui32Received >= g_ui32Bytes)
+    {
+        return(false);
+    }
+    return((HostSimTimeNs() - g_ui64LastProgress) < STALL_NS);
+}
+
+// Set port 0 to the given baud rate, 8N1, with SET_LINE_CODING.
+static void LineCodingSet(uint32_t ui32Baud)
+{
+    uint8_t pui8Coding[7];
+
+    pui8Coding[0] = (uint8_t)ui32Baud;
+    pui8Coding[1] = (uint8_t)(ui32Baud >> 8);
+    pui8Coding[2] = (uint8_t)(ui32Baud >> 16);
+    pui8Coding[3] = (uint8_t)(ui32Baud >> 24);
+    pui8Coding[4] = 0;
+    pui8Coding[5] = 0;
+    pui8Coding[6] = 8;
+    if(HostSimUSBControl(0x21, 0x20, 0, 0, sizeof(pui8Coding),
+                         pui8Coding) < 0)
+    {
+        fprintf(stderr, "cdcbench: SET_LINE_CODING stalled\n");
+        exit(1);
+    }
+}
+
+static bool BenchIdle(void)
+{
+    if(!g_bConfigured)
+    {
+        g_bConfigured = true;
+        HostSimUSBConfigure();
+        if(g_ui32Baud)
+        {
+            LineCodingSet(g_ui32Baud);
+        }
+        if(g_bBus || g_ui32Baud)
+        {
+            g_ui64BusNs = HostSimTimeNs();
+            HostSimTimeSet(g_ui64BusNs);
+        }
+        g_ui64Start = HostSimTimeNs();
+        g_ui64FirmwareStart = HostSimFirmwareNs();
+        g_ui64FirmwareMark = g_ui64FirmwareStart;
+        g_ui64LastProgress = g_ui64Start;
+        return(true);
+    }
+
+    if(g_bBus)
+    {
+        return(BusIdle());
+    }
+
+    // Collect the echo, then send until the window is full or the device
+    // NAKs.
+    while(EchoCollect() >= 0)
+    {
+    }
+    while(EchoCanSend() && EchoSend())
+    {
+    }
+    if(g_ui32Baud)
+    {
+        HostSimTimeSet(HostSimTimeNs() + (1000000000 / g_ui32Baud));
+    }
+
+    if(g_ui32Received >= g_ui32Bytes)
+    {
+        return(false);
+    }
+    return((HostSimTimeNs() - g_ui64LastProgress) < STALL_NS);
+}
+
+static int Compare(const void *pvA, const void *pvB)
+{
+    uint64_t ui64A, ui64B;
+
+    ui64A = *(const uint64_t *)pvA;
+    ui64B = *(const uint64_t *)pvB;
+    return((ui64A > ui64B) - (ui64A < ui64B));
+}
+
+static double Percentile(uint32_t ui32Count, uint32_t ui32Percent)
+{
+    if(!ui32Count)
+    {
+        return(0.0);
+    }
+    return(g_pui64Latency[((ui32Count - 1) * ui32Percent) / 100] / 1000.0);
+}
+
+#ifdef USB_PROFILE
+// Print what the firmware's probes recorded, in nanoseconds of host time.
+// The percentiles are the upper ends of their histogram buckets.
+static void ProfilePrint(void)
+{
+    static const char * const ppcNames[USB_PROBE_COUNT] =
+    {
+        "RxHandler", "TxHandler", "ControlHandler", "RxDataHandler",
+        "USBForward per 64 bytes"
+    };
+    uint32_t ui32Probe;
+
+    for(ui32Probe = 0; ui32Probe < USB_PROBE_COUNT; ui32Probe++)
+    {
+        if(!g_psUSBProfile[ui32Probe].ui32Count)
+        {
+            continue;
+        }
+        printf("probe       %s: %u calls, min %u ns, p50 %u ns, p99 %u ns, "
+               "max %u ns\n", ppcNames[ui32Probe],
+               g_psUSBProfile[ui32Probe].ui32Count,
+               g_psUSBProfile[ui32Probe].ui32Min,
+               USBProfilePercentile(ui32Probe, 50),
+               USBProfilePercentile(ui32Probe, 99),
+               g_psUSBProfile[ui32Probe].ui32Max);
+    }
+}
+#endif
+
+static void Usage(const char *pcName)
+{
+    fprintf(stderr,
+            "usage: %s [-n bytes] [-w window] [-s size] [-b] [-c scale] "
+            "[-r baud]\n"
+            "  -n bytes   data to echo (default %u)\n"
+            "  -w window  packets in flight (default %u)\n"
+            "  -s size    bytes per packet, up to %u (default %u)\n"
+            "  -b         run against the full-speed bus model\n"
+            "  -c scale   processor time per host time with -b (default %u)\n"
+            "  -r baud    set the line coding of port 0 first, not with -b\n",
+            pcName, g_ui32Bytes, g_ui32Window, PACKET_SIZE, PACKET_SIZE,
+            g_ui32CPUScale);
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t ui64WallNs, ui64FirmwareNs;
+    uint32_t ui32Packets;
+    int iArg;
+
+    for(iArg = 1; iArg < argc; iArg++)
+    {
+        if((iArg + 1 < argc) && !strcmp(argv[iArg], "-n"))
+        {
+            g_ui32Bytes = strtoul(argv[++iArg], 0, 0);
+        }
+        else if((iArg + 1 < argc) && !strcmp(argv[iArg], "-w"))
+        {
+            g_ui32Window = strtoul(argv[++iArg], 0, 0);
+        }
+        else if((iArg + 1 < argc) && !strcmp(argv[iArg], "-s"))
+        {
+            g_ui32PacketSize = strtoul(argv[++iArg], 0, 0);
+        }
+        else if(!strcmp(argv[iArg], "-b"))
+        {
+            g_bBus = true;
+        }
+        else if((iArg + 1 < argc) && !strcmp(argv[iArg], "-c"))
+        {
+            g_ui32CPUScale = strtoul(argv[++iArg], 0, 0);
+        }
+        else if((iArg + 1 < argc) && !strcmp(argv[iArg], "-r"))
+        {
+            g_ui32Baud = strtoul(argv[++iArg], 0, 0);
+        }
+        else
+        {
+            Usage(argv[0]);
+        }
+    }
+#ifdef USB_COMMANDS
+    // Whole command lines only.
+    g_ui32Bytes -= g_ui32Bytes % COMMAND_SIZE;
+#endif
+    if(!g_ui32Bytes || !g_ui32Window || !g_ui32PacketSize ||
+       (g_ui32PacketSize > PACKET_SIZE) || (g_bBus && g_ui32Baud))
+    {
+        Usage(argv[0]);
+    }
+
+    ui32Packets = (g_ui32Bytes + g_ui32PacketSize - 1) / g_ui32PacketSize;
+    g_pui64Latency = calloc(ui32Packets, sizeof(uint64_t));
+    if(!g_pui64Latency)
+    {
+        return(1);
+    }
+
+    HostSimRun(FirmwareMain, BenchIdle);
+
+    ui64WallNs = HostSimTimeNs() - g_ui64Start;
+    ui64FirmwareNs = HostSimFirmwareNs() - g_ui64FirmwareStart;
+    qsort(g_pui64Latency, g_ui32PacketsDone, sizeof(uint64_t), Compare);
+
+    printf("echoed      %u of %u bytes in %u-byte packets, window %u\n",
+           g_ui32Received, g_ui32Bytes, g_ui32PacketSize, g_ui32Window);
+    if(g_bBus)
+    {
+        printf("throughput  %.1f KB/s over the bus, processor %.0f%% busy "
+               "at scale %u\n",
+               ui64WallNs ? (g_ui32Received * 1000000.0) / ui64WallNs : 0.0,
+               ui64WallNs ? (g_ui64CPUNs * 100.0) / ui64WallNs : 0.0,
+               g_ui32CPUScale);
+    }
+    else if(g_ui32Baud)
+    {
+        printf("throughput  %.1f MB/s in the firmware, %.1f KB/s on the "
+               "line\n",
+               ui64FirmwareNs ?
+               (g_ui32Received * 1000.0) / ui64FirmwareNs : 0.0,
+               ui64WallNs ? (g_ui32Received * 1000000.0) / ui64WallNs : 0.0);
+    }
+    else
+    {
+        printf("throughput  %.1f MB/s in the firmware, %.1f MB/s wall clock\n",
+               ui64FirmwareNs ?
+               (g_ui32Received * 1000.0) / ui64FirmwareNs : 0.0,
+               ui64WallNs ? (g_ui32Received * 1000.0) / ui64WallNs : 0.0);
+    }
+#ifdef USB_COMMANDS
+    printf("commands    %u, %.0f per second in the firmware, %.0f per second "
+           "%s\n", g_ui32Received / COMMAND_SIZE,
+           ui64FirmwareNs ?
+           (g_ui32Received * 1e9) / (COMMAND_SIZE * ui64FirmwareNs) : 0.0,
+           ui64WallNs ?
+           (g_ui32Received * 1e9) / (COMMAND_SIZE * ui64WallNs) : 0.0,
+           g_bBus ? "over the bus" : "wall clock");
+#endif
+    printf("firmware    %.0f ns per packet, %u USB interrupts\n",
+           g_ui32PacketsDone ?
+           (double)ui64FirmwareNs / g_ui32PacketsDone : 0.0,
+           HostSimInterrupts(INT_USB0));
+    if(g_ui32Received)
+    {
+        printf("per KB      %.0f ns firmware, %.1f USB, %.1f UART and %.1f "
+               "PendSV interrupts\n",
+               (ui64FirmwareNs * 1024.0) / g_ui32Received,
+               (HostSimInterrupts(INT_USB0) * 1024.0) / g_ui32Received,
+               (HostSimInterrupts(INT_UART0) * 1024.0) / g_ui32Received,
+               (HostSimInterrupts(FAULT_PENDSV) * 1024.0) / g_ui32Received);
+    }
+    printf("round trip  p50 %.2f us, p90 %.2f us, p99 %.2f us, max %.2f us\n",
+           Percentile(g_ui32PacketsDone, 50), Percentile(g_ui32PacketsDone, 90),
+           Percentile(g_ui32PacketsDone, 99),
+           Percentile(g_ui32PacketsDone, 100));
+#ifdef USB_PROFILE
+    ProfilePrint();
+#endif
+    printf("NAKs        %u OUT, %u IN\n", g_ui32NAKs, g_ui32INNAKs);
+    printf("dropped     %u bytes\n", g_ui32Sent - g_ui32Received);
+    printf("mismatched  %u bytes\n", g_ui32Mismatches);
+
+    return(((g_ui32Received == g_ui32Bytes) && !g_ui32Mismatches) ? 0 : 1);
+}
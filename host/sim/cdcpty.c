@@ -0,0 +1,216 @@
+/*
+ * cdcpty.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// The host build of the firmware behind a pseudo-terminal, so that host
+// tools such as cdcbench.py can talk to the real driver code with no board
+// attached.  The name of the terminal's slave side is printed on the first
+// line of the output; a tool opens it as it would /dev/ttyACM0.
+//
+// The bench plays the USB host on port 0: what the tool writes is sent to
+// the OUT endpoint in packets of up to 64 bytes, retried while the device
+// NAKs, and whatever the IN endpoint returns is written back to the tool.
+// The IN endpoint is not polled while the tool has not taken the last
+// packet, so a slow reader holds the device up as a slow host would.  The
+// firmware runs on the host's clock, so its latency timer and SysTick behave
+// as on the board.  Run until SIGINT or SIGTERM.
+//
+// Built with USB_COMPRESS (cdcpty-compress) the host switches compression
+// of port 0 on before any data is sent, as lz4stream.enable() does.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "hostsim.h"
+
+#define PACKET_SIZE             64
+
+// How long to wait for the tool when nothing moved, in milliseconds.  The
+// firmware's timers are still run at least this often.
+#define IDLE_MS                 1
+
+// Vendor request of usbconfig.c that switches compression on.
+#define REQ_COMPRESS            0x04
+#define REQ_TYPE_VENDOR_OUT     0x40
+
+extern int FirmwareMain(void);
+
+static int g_iMaster;
+static bool g_bConfigured;
+static volatile sig_atomic_t g_bStop;
+
+// A packet read from the tool and not yet taken by the device.
+static uint8_t g_pui8Out[PACKET_SIZE];
+static uint32_t g_ui32OutSize;
+
+// A packet from the device not yet all written to the tool.
+static uint8_t g_pui8In[PACKET_SIZE];
+static uint32_t g_ui32InSize;
+static uint32_t g_ui32InSent;
+
+static void Stop(int iSignal)
+{
+    g_bStop = true;
+}
+
+// Open the pseudo-terminal in raw mode and print the slave's name.  The
+// slave is kept open as well, so that the master never sees a hangup while
+// no tool has it open.
+static void PtyOpen(void)
+{
+    struct termios sTerm;
+    const char *pcName;
+    int iSlave;
+
+    g_iMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if((g_iMaster < 0) || grantpt(g_iMaster) || unlockpt(g_iMaster))
+    {
+        perror("cdcpty: posix_openpt");
+        exit(1);
+    }
+    pcName = ptsname(g_iMaster);
+    iSlave = pcName ? open(pcName, O_RDWR | O_NOCTTY) : -1;
+    if(iSlave < 0)
+    {
+        perror("cdcpty: open slave");
+        exit(1);
+    }
+
+    tcgetattr(iSlave, &sTerm);
+    cfmakeraw(&sTerm);
+    tcsetattr(iSlave, TCSANOW, &sTerm);
+    fcntl(g_iMaster, F_SETFL, fcntl(g_iMaster, F_GETFL) | O_NONBLOCK);
+
+    printf("%s\n", pcName);
+    fflush(stdout);
+}
+
+// Move data between the tool and the device.  Returns true if anything
+// moved.
+static bool PtyTransfer(void)
+{
+    ssize_t iCount;
+    int32_t i32Size;
+    bool bMoved;
+
+    bMoved = false;
+
+    // Hand the tool what is left of the last IN packet, then collect the
+    // next one.
+    while(true)
+    {
+        if(g_ui32InSent < g_ui32InSize)
+        {
+            iCount = write(g_iMaster, &g_pui8In[g_ui32InSent],
+                           g_ui32InSize - g_ui32InSent);
+            if(iCount <= 0)
+            {
+                break;
+            }
+            g_ui32InSent += iCount;
+            bMoved = true;
+            continue;
+        }
+        i32Size = HostSimUSBIn(0, g_pui8In);
+        if(i32Size < 0)
+        {
+            break;
+        }
+        g_ui32InSize = i32Size;
+        g_ui32InSent = 0;
+        bMoved = true;
+    }
+
+    // Send what the tool has written until the device NAKs.
+    while(true)
+    {
+        if(!g_ui32OutSize)
+        {
+            iCount = read(g_iMaster, g_pui8Out, PACKET_SIZE);
+            if(iCount <= 0)
+            {
+                break;
+            }
+            g_ui32OutSize = iCount;
+        }
+        if(!HostSimUSBOut(0, g_pui8Out, g_ui32OutSize))
+        {
+            break;
+        }
+        g_ui32OutSize = 0;
+        bMoved = true;
+    }
+
+    return(bMoved);
+}
+
+static bool PtyIdle(void)
+{
+    struct pollfd sPoll;
+#ifdef USB_COMPRESS
+    uint8_t pui8On[1];
+#endif
+
+    if(!g_bConfigured)
+    {
+        g_bConfigured = true;
+        HostSimUSBConfigure();
+#ifdef USB_COMPRESS
+        if(HostSimUSBControl(REQ_TYPE_VENDOR_OUT, REQ_COMPRESS, 1, 0, 0,
+                             pui8On) < 0)
+        {
+            fprintf(stderr, "cdcpty: compression request stalled\n");
+            exit(1);
+        }
+#endif
+        return(true);
+    }
+
+    // Wait for the tool only when neither side moved.  While the tool has
+    // not taken the last packet, or the device NAKs a packet, poll for the
+    // master to be ready in that direction.
+    if(!PtyTransfer())
+    {
+        sPoll.fd = g_iMaster;
+        sPoll.events = 0;
+        if(g_ui32InSent < g_ui32InSize)
+        {
+            sPoll.events |= POLLOUT;
+        }
+        if(!g_ui32OutSize)
+        {
+            sPoll.events |= POLLIN;
+        }
+        if((poll(&sPoll, 1, IDLE_MS) < 0) && (errno != EINTR))
+        {
+            perror("cdcpty: poll");
+            return(false);
+        }
+    }
+
+    return(!g_bStop);
+}
+
+int main(int argc, char *argv[])
+{
+    signal(SIGINT, Stop);
+    signal(SIGTERM, Stop);
+    signal(SIGPIPE, SIG_IGN);
+
+    PtyOpen();
+    HostSimRun(FirmwareMain, PtyIdle);
+    close(g_iMaster);
+    return(0);
+}
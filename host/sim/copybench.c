@@ -0,0 +1,127 @@
+/*
+ * copybench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Copy benchmark for the receive to transmit path of the echo.  Each round
+// puts one packet into port 0's receive buffer, as the USB interrupt would,
+// and times only the handler that moves it to the transmit buffer:
+//
+// - bounce: the original RxDataHandler(), which reads everything waiting
+//   into an array on the stack with USBBufferRead(), flushes the receive
+//   buffer and writes the array to the transmit buffer with
+//   USBBufferWrite().  The array holds a full packet here; the original one
+//   of 32 bytes overflowed on anything longer.
+// - forward: USBForward(), which copies straight from one ring to the other
+//   through the span API.
+//
+// Time is counted in cycles of the host's time stamp counter, so the
+// results compare the two handlers on the same machine rather than predict
+// cycles on the Cortex-M4.  Both rings are the firmware's own, set up by
+// USBInit() with no host attached, so nothing is sent and the transmit
+// buffer is emptied between rounds outside the timing.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "hostsim.h"
+
+#define ROUNDS                  200000
+#define PACKET_SIZE             64
+
+static uint64_t Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return(__rdtsc());
+#else
+    return(HostSimTimeNs());
+#endif
+}
+
+static void BounceHandler(void)
+{
+    uint32_t ui32Count;
+    uint8_t pui8Data[PACKET_SIZE];
+
+    ui32Count = USBBufferDataAvailable(&RxBuffer);
+    USBBufferRead(&RxBuffer, pui8Data, ui32Count);
+    USBBufferFlush(&RxBuffer);
+    USBBufferWrite(&TxBuffer, pui8Data, ui32Count);
+}
+
+static void ForwardHandler(void)
+{
+    USBForward(&RxBuffer, &TxBuffer);
+}
+
+// Run a handler for ROUNDS packets of ui32Size bytes and return the bytes
+// moved per cycle.  The ring positions advance by the packet size every
+// round, so copies start at every alignment and wrap as they would.
+static double Run(void (*pfnHandler)(void), uint32_t ui32Size)
+{
+    uint8_t pui8Packet[PACKET_SIZE];
+    uint64_t ui64Cycles, ui64Start;
+    uint32_t ui32Round, ui32Moved;
+
+    for(ui32Round = 0; ui32Round < ui32Size; ui32Round++)
+    {
+        pui8Packet[ui32Round] = (uint8_t)ui32Round;
+    }
+
+    USBBufferFlush(&RxBuffer);
+    USBBufferFlush(&TxBuffer);
+    ui64Cycles = 0;
+    ui32Moved = 0;
+    for(ui32Round = 0; ui32Round < ROUNDS; ui32Round++)
+    {
+        USBBufferWrite(&RxBuffer, pui8Packet, ui32Size);
+
+        ui64Start = Cycles();
+        pfnHandler();
+        ui64Cycles += Cycles() - ui64Start;
+
+        ui32Moved += USBBufferDataAvailable(&TxBuffer);
+        USBBufferFlush(&TxBuffer);
+    }
+
+    if(ui32Moved != (ROUNDS * ui32Size))
+    {
+        fprintf(stderr, "copybench: moved %u bytes of %u\n", ui32Moved,
+                ROUNDS * ui32Size);
+        exit(1);
+    }
+    return((double)ui32Moved / ui64Cycles);
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t pui32Sizes[] = { 1, 8, 32, 63, 64 };
+    double dBounce, dForward;
+    uint32_t ui32Idx;
+
+    USBInit();
+
+    printf("bytes  bounce B/cycle  forward B/cycle  speedup\n");
+    for(ui32Idx = 0; ui32Idx < (sizeof(pui32Sizes) / sizeof(pui32Sizes[0]));
+        ui32Idx++)
+    {
+        dBounce = Run(BounceHandler, pui32Sizes[ui32Idx]);
+        dForward = Run(ForwardHandler, pui32Sizes[ui32Idx]);
+        printf("%5u  %14.3f  %15.3f  %6.2fx\n", pui32Sizes[ui32Idx], dBounce,
+               dForward, dForward / dBounce);
+    }
+    return(0);
+}
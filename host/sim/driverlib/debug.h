@@ -0,0 +1,15 @@
+/*
+ * debug.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/debug.h.
+
+#ifndef __DRIVERLIB_DEBUG_H__
+#define __DRIVERLIB_DEBUG_H__
+
+#define ASSERT(expr)
+
+#endif // __DRIVERLIB_DEBUG_H__
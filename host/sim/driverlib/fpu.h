@@ -0,0 +1,13 @@
+/*
+ * fpu.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/fpu.h.  Nothing in it is used.
+
+#ifndef __DRIVERLIB_FPU_H__
+#define __DRIVERLIB_FPU_H__
+
+#endif // __DRIVERLIB_FPU_H__
@@ -0,0 +1,23 @@
+/*
+ * interrupt.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/interrupt.h.  See hostsim.c for the
+// model of the NVIC behind it.
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+extern bool IntMasterEnable(void);
+extern bool IntMasterDisable(void);
+extern void IntEnable(uint32_t ui32Interrupt);
+extern void IntDisable(uint32_t ui32Interrupt);
+extern void IntPendSet(uint32_t ui32Interrupt);
+extern void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority);
+extern void IntPriorityMaskSet(uint32_t ui32PriorityMask);
+extern uint32_t IntPriorityMaskGet(void);
+
+#endif // __DRIVERLIB_INTERRUPT_H__
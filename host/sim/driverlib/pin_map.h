@@ -0,0 +1,20 @@
+/*
+ * pin_map.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/pin_map.h (TM4C123GH6PM).
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PB0_U1RX           0x00010001
+#define GPIO_PB1_U1TX           0x00010401
+#define GPIO_PC6_U3RX           0x00021801
+#define GPIO_PC7_U3TX           0x00021C01
+
+#endif // __DRIVERLIB_PIN_MAP_H__
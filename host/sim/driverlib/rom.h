@@ -0,0 +1,70 @@
+/*
+ * rom.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/rom.h.  There is no ROM on the host,
+// so every ROM_ call goes to the flash version of the function.
+
+#ifndef __DRIVERLIB_ROM_H__
+#define __DRIVERLIB_ROM_H__
+
+#define ROM_GPIOPadConfigSet                GPIOPadConfigSet
+#define ROM_GPIOPinConfigure                GPIOPinConfigure
+#define ROM_GPIOPinRead                     GPIOPinRead
+#define ROM_GPIOPinTypeGPIOInput            GPIOPinTypeGPIOInput
+#define ROM_GPIOPinTypeGPIOOutput           GPIOPinTypeGPIOOutput
+#define ROM_GPIOPinTypeUART                 GPIOPinTypeUART
+#define ROM_GPIOPinTypeUSBAnalog            GPIOPinTypeUSBAnalog
+#define ROM_GPIOPinWrite                    GPIOPinWrite
+#define ROM_IntDisable                      IntDisable
+#define ROM_IntEnable                       IntEnable
+#define ROM_IntMasterDisable                IntMasterDisable
+#define ROM_IntMasterEnable                 IntMasterEnable
+#define ROM_IntPendSet                      IntPendSet
+#define ROM_IntPrioritySet                  IntPrioritySet
+#define ROM_SysCtlClockGet                  SysCtlClockGet
+#define ROM_SysCtlClockSet                  SysCtlClockSet
+#define ROM_SysCtlDeepSleep                 SysCtlDeepSleep
+#define ROM_SysCtlPeripheralClockGating     SysCtlPeripheralClockGating
+#define ROM_SysCtlPeripheralDeepSleepEnable SysCtlPeripheralDeepSleepEnable
+#define ROM_SysCtlPeripheralEnable          SysCtlPeripheralEnable
+#define ROM_SysCtlPeripheralSleepEnable     SysCtlPeripheralSleepEnable
+#define ROM_SysCtlSleep                     SysCtlSleep
+#define ROM_SysTickDisable                  SysTickDisable
+#define ROM_SysTickEnable                   SysTickEnable
+#define ROM_SysTickIntEnable                SysTickIntEnable
+#define ROM_SysTickPeriodSet                SysTickPeriodSet
+#define ROM_SysTickValueGet                 SysTickValueGet
+#define ROM_TimerConfigure                  TimerConfigure
+#define ROM_TimerEnable                     TimerEnable
+#define ROM_TimerIntClear                   TimerIntClear
+#define ROM_TimerIntEnable                  TimerIntEnable
+#define ROM_TimerLoadSet                    TimerLoadSet
+#define ROM_TimerValueGet                   TimerValueGet
+#define ROM_UARTBusy                        UARTBusy
+#define ROM_UARTCharGetNonBlocking          UARTCharGetNonBlocking
+#define ROM_UARTCharPutNonBlocking          UARTCharPutNonBlocking
+#define ROM_UARTCharsAvail                  UARTCharsAvail
+#define ROM_UARTConfigGetExpClk             UARTConfigGetExpClk
+#define ROM_UARTConfigSetExpClk             UARTConfigSetExpClk
+#define ROM_UARTDMAEnable                   UARTDMAEnable
+#define ROM_UARTFIFOLevelSet                UARTFIFOLevelSet
+#define ROM_UARTIntClear                    UARTIntClear
+#define ROM_UARTIntDisable                  UARTIntDisable
+#define ROM_UARTIntEnable                   UARTIntEnable
+#define ROM_UARTIntStatus                   UARTIntStatus
+#define ROM_UARTSpaceAvail                  UARTSpaceAvail
+#define ROM_uDMAChannelAttributeDisable     uDMAChannelAttributeDisable
+#define ROM_uDMAChannelControlSet           uDMAChannelControlSet
+#define ROM_uDMAChannelDisable              uDMAChannelDisable
+#define ROM_uDMAChannelEnable               uDMAChannelEnable
+#define ROM_uDMAChannelIsEnabled            uDMAChannelIsEnabled
+#define ROM_uDMAChannelSizeGet              uDMAChannelSizeGet
+#define ROM_uDMAChannelTransferSet          uDMAChannelTransferSet
+#define ROM_uDMAControlBaseSet              uDMAControlBaseSet
+#define ROM_uDMAEnable                      uDMAEnable
+
+#endif // __DRIVERLIB_ROM_H__
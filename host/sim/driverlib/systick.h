@@ -0,0 +1,20 @@
+/*
+ * systick.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/systick.h.  The counter runs from
+// the simulation clock in hostsim.c.
+
+#ifndef __DRIVERLIB_SYSTICK_H__
+#define __DRIVERLIB_SYSTICK_H__
+
+extern void SysTickEnable(void);
+extern void SysTickDisable(void);
+extern void SysTickIntEnable(void);
+extern void SysTickPeriodSet(uint32_t ui32Period);
+extern uint32_t SysTickValueGet(void);
+
+#endif // __DRIVERLIB_SYSTICK_H__
@@ -0,0 +1,25 @@
+/*
+ * timer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/timer.h.  The timers never run.
+
+#ifndef __DRIVERLIB_TIMER_H__
+#define __DRIVERLIB_TIMER_H__
+
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_A                 0x000000ff
+#define TIMER_TIMA_TIMEOUT      0x00000001
+
+extern void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+extern void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer,
+                         uint32_t ui32Value);
+extern void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+extern uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer);
+
+#endif // __DRIVERLIB_TIMER_H__
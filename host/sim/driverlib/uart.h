@@ -0,0 +1,61 @@
+/*
+ * uart.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/uart.h.
+
+#ifndef __DRIVERLIB_UART_H__
+#define __DRIVERLIB_UART_H__
+
+#define UART_INT_RT             0x00000040
+#define UART_INT_TX             0x00000020
+#define UART_INT_RX             0x00000010
+
+#define UART_CONFIG_WLEN_MASK   0x00000060
+#define UART_CONFIG_WLEN_8      0x00000060
+#define UART_CONFIG_WLEN_7      0x00000040
+#define UART_CONFIG_WLEN_6      0x00000020
+#define UART_CONFIG_WLEN_5      0x00000000
+#define UART_CONFIG_STOP_MASK   0x00000008
+#define UART_CONFIG_STOP_ONE    0x00000000
+#define UART_CONFIG_STOP_TWO    0x00000008
+#define UART_CONFIG_PAR_MASK    0x00000086
+#define UART_CONFIG_PAR_NONE    0x00000000
+#define UART_CONFIG_PAR_EVEN    0x00000006
+#define UART_CONFIG_PAR_ODD     0x00000002
+#define UART_CONFIG_PAR_ONE     0x00000082
+#define UART_CONFIG_PAR_ZERO    0x00000086
+
+#define UART_FIFO_TX4_8         0x00000002
+#define UART_FIFO_RX4_8         0x00000010
+
+#define UART_DMA_TX             0x00000002
+
+#define UART_TXINT_MODE_FIFO    0x00000000
+
+#define UART_CLOCK_SYSTEM       0x00000000
+#define UART_CLOCK_PIOSC        0x00000005
+
+extern void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                                uint32_t ui32Baud, uint32_t ui32Config);
+extern void UARTConfigGetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                                uint32_t *pui32Baud, uint32_t *pui32Config);
+extern void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                             uint32_t ui32RxLevel);
+extern void UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode);
+extern void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source);
+extern void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked);
+extern void UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern bool UARTSpaceAvail(uint32_t ui32Base);
+extern bool UARTCharsAvail(uint32_t ui32Base);
+extern bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData);
+extern int32_t UARTCharGetNonBlocking(uint32_t ui32Base);
+extern bool UARTBusy(uint32_t ui32Base);
+
+#endif // __DRIVERLIB_UART_H__
@@ -0,0 +1,55 @@
+/*
+ * udma.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/udma.h.
+
+#ifndef __DRIVERLIB_UDMA_H__
+#define __DRIVERLIB_UDMA_H__
+
+typedef struct
+{
+    volatile void *pvSrcEndAddr;
+    volatile void *pvDstEndAddr;
+    volatile uint32_t ui32Control;
+    volatile uint32_t ui32Spare;
+} tDMAControlTable;
+
+#define UDMA_PRI_SELECT         0x00000000
+#define UDMA_ALT_SELECT         0x00000020
+
+#define UDMA_ATTR_ALL           0x0000000F
+
+#define UDMA_SIZE_8             0x00000000
+#define UDMA_SRC_INC_8          0x00000000
+#define UDMA_DST_INC_NONE       0xC0000000
+#define UDMA_ARB_4              0x00008000
+
+#define UDMA_MODE_BASIC         0x00000001
+
+#define UDMA_CHANNEL_UART0TX    9
+#define UDMA_CHANNEL_UART1TX    23
+
+#define UDMA_CH9_UART0TX        0x00000009
+#define UDMA_CH17_UART3TX       0x00010011
+#define UDMA_CH23_UART1TX       0x00000017
+
+extern void uDMAEnable(void);
+extern void uDMAControlBaseSet(void *pControlTable);
+extern void uDMAChannelAssign(uint32_t ui32Mapping);
+extern void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum,
+                                        uint32_t ui32Attr);
+extern void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex,
+                                  uint32_t ui32Control);
+extern void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex,
+                                   uint32_t ui32Mode, void *pvSrcAddr,
+                                   void *pvDstAddr, uint32_t ui32TransferSize);
+extern void uDMAChannelEnable(uint32_t ui32ChannelNum);
+extern void uDMAChannelDisable(uint32_t ui32ChannelNum);
+extern bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum);
+extern uint32_t uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex);
+
+#endif // __DRIVERLIB_UDMA_H__
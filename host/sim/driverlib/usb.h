@@ -0,0 +1,38 @@
+/*
+ * usb.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare driverlib/usb.h.  Only the endpoint FIFO
+// configuration is modelled, in usblib.c.
+
+#ifndef __DRIVERLIB_USB_H__
+#define __DRIVERLIB_USB_H__
+
+#define USB_EP_0                0x00000000
+#define USB_EP_1                0x00000010
+#define USB_EP_2                0x00000020
+#define USB_EP_3                0x00000030
+#define USB_EP_4                0x00000040
+#define USB_EP_5                0x00000050
+#define USB_EP_6                0x00000060
+#define USB_EP_7                0x00000070
+
+#define USB_EP_DEV_IN           0x00002000
+#define USB_EP_DEV_OUT          0x00000000
+
+#define USB_FIFO_SZ_64          0x00000003
+#define USB_FIFO_SZ_64_DB       0x00000013
+#define USB_FIFO_SIZE_DB_FLAG   0x00000010
+
+extern void USBFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Endpoint,
+                             uint32_t ui32FIFOAddress, uint32_t ui32FIFOSize,
+                             uint32_t ui32Flags);
+extern void USBFIFOFlush(uint32_t ui32Base, uint32_t ui32Endpoint,
+                         uint32_t ui32Flags);
+extern void USBDevEndpointDataAck(uint32_t ui32Base, uint32_t ui32Endpoint,
+                                  bool bIsLastPacket);
+
+#endif // __DRIVERLIB_USB_H__
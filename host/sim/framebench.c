@@ -0,0 +1,220 @@
+/*
+ * framebench.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Benchmark for the framing layer in usbframe.c.  For each payload size a
+// set of random payloads, with zeros among them as real records have, is
+// framed with USBFrameEncode() into the transmit buffer and the encoded
+// stream is fed back through the receive buffer to USBFrameDecode(),
+// as the USB interrupt and the main loop would:
+//
+// - encode: the time USBFrameEncode() takes per frame, over the payload
+//   bytes.
+// - decode: the time USBFrameDecode() takes to take the stream out of the
+//   receive buffer, over the encoded bytes.  The buffer is filled with
+//   three 64-byte packets at a time, so every decode starts on a packet
+//   boundary and frames span calls.
+//
+// Only the calls themselves are timed, on the host's monotonic clock, so the
+// results compare builds on the same machine rather than predict the
+// Cortex-M4.  Both rings are the firmware's own, set up by USBInit() with no
+// host attached, and every payload is checked after decoding outside the
+// timing.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbframe.h"
+#include "hostsim.h"
+
+// Bytes of payload framed and decoded per size, the number of different
+// payloads cycled through and the largest payload, which with its overhead
+// has to fit in the transmit buffer.
+#define PAYLOAD_BYTES           (8 * 1024 * 1024)
+#define PAYLOADS                16
+#define MAX_PAYLOAD             192
+
+// Bytes written to the receive buffer before each decode.
+#define DECODE_CHUNK            (3 * 64)
+
+static uint8_t g_ppui8Payloads[PAYLOADS][MAX_PAYLOAD];
+static uint8_t g_pui8Frame[MAX_PAYLOAD + 4];
+
+// The encoded stream of each payload.
+static uint8_t g_ppui8Encoded[PAYLOADS][MAX_PAYLOAD +
+                                        USB_FRAME_OVERHEAD(MAX_PAYLOAD)];
+static uint32_t g_pui32Encoded[PAYLOADS];
+
+// Frames decoded and whether all of them matched their payloads.
+static uint32_t g_ui32Decoded;
+static bool g_bCheck;
+static bool g_bMismatch;
+
+static void FrameReceived(void *pvCBData, uint8_t *pui8Frame,
+                          uint32_t ui32Size)
+{
+    const uint8_t *pui8Payload;
+
+    if(g_bCheck)
+    {
+        pui8Payload = g_ppui8Payloads[g_ui32Decoded % PAYLOADS];
+        if((ui32Size != *(uint32_t *)pvCBData) ||
+           memcmp(pui8Frame, pui8Payload, ui32Size))
+        {
+            g_bMismatch = true;
+        }
+    }
+    g_ui32Decoded++;
+}
+
+// Frame every payload of ui32Size bytes once to build the encoded streams,
+// then ui32Frames times in all for the timing.  Returns the nanoseconds
+// spent in USBFrameEncode().
+static uint64_t Encode(uint32_t ui32Size, uint32_t ui32Frames)
+{
+    uint64_t ui64Ns, ui64Start;
+    uint32_t ui32Frame, ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < PAYLOADS; ui32Idx++)
+    {
+        USBBufferFlush(&TxBuffer);
+        if(!USBFrameEncode(&TxBuffer, g_ppui8Payloads[ui32Idx], ui32Size))
+        {
+            fprintf(stderr, "framebench: no room for a %u-byte frame\n",
+                    ui32Size);
+            exit(1);
+        }
+        g_pui32Encoded[ui32Idx] = USBBufferRead(&TxBuffer,
+                                                g_ppui8Encoded[ui32Idx],
+                                                sizeof(g_ppui8Encoded[0]));
+    }
+
+    ui64Ns = 0;
+    for(ui32Frame = 0; ui32Frame < ui32Frames; ui32Frame++)
+    {
+        USBBufferFlush(&TxBuffer);
+
+        ui64Start = HostSimTimeNs();
+        USBFrameEncode(&TxBuffer, g_ppui8Payloads[ui32Frame % PAYLOADS],
+                       ui32Size);
+        ui64Ns += HostSimTimeNs() - ui64Start;
+    }
+    USBBufferFlush(&TxBuffer);
+    return(ui64Ns);
+}
+
+// Feed ui32Frames frames of the encoded streams through the receive buffer
+// to a decoder.  Returns the nanoseconds spent in USBFrameDecode() and the
+// encoded bytes in *pui32Bytes.
+static uint64_t Decode(uint32_t ui32Size, uint32_t ui32Frames,
+                       uint32_t *pui32Bytes)
+{
+    tUSBFrameDecoder sDecoder;
+    uint64_t ui64Ns, ui64Start;
+    uint32_t ui32Frame, ui32Offset, ui32Count, ui32Space, ui32Bytes;
+
+    USBFrameDecoderInit(&sDecoder, g_pui8Frame, sizeof(g_pui8Frame),
+                        FrameReceived, &ui32Size);
+    USBBufferFlush(&RxBuffer);
+    g_ui32Decoded = 0;
+
+    ui64Ns = 0;
+    ui32Bytes = 0;
+    ui32Frame = 0;
+    ui32Offset = 0;
+    while(ui32Frame < ui32Frames)
+    {
+        // Fill the receive buffer with the next part of the stream.
+        ui32Space = DECODE_CHUNK;
+        while(ui32Space && (ui32Frame < ui32Frames))
+        {
+            ui32Count = g_pui32Encoded[ui32Frame % PAYLOADS] - ui32Offset;
+            if(ui32Count > ui32Space)
+            {
+                ui32Count = ui32Space;
+            }
+            USBBufferWrite(&RxBuffer,
+                           &g_ppui8Encoded[ui32Frame % PAYLOADS][ui32Offset],
+                           ui32Count);
+            ui32Space -= ui32Count;
+            ui32Offset += ui32Count;
+            if(ui32Offset == g_pui32Encoded[ui32Frame % PAYLOADS])
+            {
+                ui32Offset = 0;
+                ui32Frame++;
+            }
+        }
+        ui32Bytes += DECODE_CHUNK - ui32Space;
+
+        ui64Start = HostSimTimeNs();
+        USBFrameDecode(&sDecoder, &RxBuffer);
+        ui64Ns += HostSimTimeNs() - ui64Start;
+    }
+
+    if((g_ui32Decoded != ui32Frames) || sDecoder.ui32CRCErrors ||
+       sDecoder.ui32FramingErrors || sDecoder.ui32Overflows || g_bMismatch)
+    {
+        fprintf(stderr, "framebench: decoded %u of %u %u-byte frames, %u CRC "
+                "errors, %u framing errors, %u overflows%s\n", g_ui32Decoded,
+                ui32Frames, ui32Size, sDecoder.ui32CRCErrors,
+                sDecoder.ui32FramingErrors, sDecoder.ui32Overflows,
+                g_bMismatch ? ", payload mismatch" : "");
+        exit(1);
+    }
+
+    *pui32Bytes = ui32Bytes;
+    return(ui64Ns);
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t pui32Sizes[] = { 8, 32, 64, 128, MAX_PAYLOAD };
+    uint64_t ui64EncodeNs, ui64DecodeNs;
+    uint32_t ui32Idx, ui32Byte, ui32Frames, ui32Bytes;
+
+    USBInit();
+    USBFrameInit();
+
+    // Random bytes with about one zero in sixteen.
+    srand(1);
+    for(ui32Idx = 0; ui32Idx < PAYLOADS; ui32Idx++)
+    {
+        for(ui32Byte = 0; ui32Byte < MAX_PAYLOAD; ui32Byte++)
+        {
+            g_ppui8Payloads[ui32Idx][ui32Byte] =
+                (rand() & 15) ? (uint8_t)rand() : 0;
+        }
+    }
+
+    printf("bytes  encode MB/s  decode MB/s  encoded bytes per frame\n");
+    for(ui32Idx = 0; ui32Idx < (sizeof(pui32Sizes) / sizeof(pui32Sizes[0]));
+        ui32Idx++)
+    {
+        ui32Frames = PAYLOAD_BYTES / pui32Sizes[ui32Idx];
+        ui64EncodeNs = Encode(pui32Sizes[ui32Idx], ui32Frames);
+
+        // Check every payload once, then time the decode alone.
+        g_bCheck = true;
+        Decode(pui32Sizes[ui32Idx], PAYLOADS, &ui32Bytes);
+        g_bCheck = false;
+        ui64DecodeNs = Decode(pui32Sizes[ui32Idx], ui32Frames, &ui32Bytes);
+
+        printf("%5u  %11.1f  %11.1f  %23.1f\n", pui32Sizes[ui32Idx],
+               ((double)ui32Frames * pui32Sizes[ui32Idx] * 1000.0) /
+               ui64EncodeNs,
+               (ui32Bytes * 1000.0) / ui64DecodeNs,
+               (double)ui32Bytes / ui32Frames);
+    }
+    return(0);
+}
@@ -0,0 +1,1141 @@
+/*
+ * hostsim.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// The simulated processor: register file, NVIC, SysTick and the driverlib
+// calls the firmware makes, other than the USB ones which are in usblib.c.
+// See hostsim.h.
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_sysctl.h"
+#include "inc/hw_types.h"
+#include "inc/hw_uart.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "utils/uartstdio.h"
+#include "usbstack.h"
+#include "hostsim.h"
+
+// The DWT cycle counter, which usbprofile.c reads through HWREG().
+#define DWT_CYCCNT              0xE0001004
+
+// The interrupt handlers, as wired up in startup_ccs.c.
+extern void USBUARTIntHandler(void);
+extern void USBUARTPort1IntHandler(void);
+extern void USBUARTPort2IntHandler(void);
+extern void USBUARTFlowIntHandler(void);
+extern void USBTickHandler(void);
+extern void USBUARTDeferredIntHandler(void);
+extern void USBLatencyUSBIntHandler(void);
+extern void USBLatencyUARTIntHandler(void);
+
+// The stack the TI linker sets aside between __stack and __STACK_TOP, which
+// usbstack.c scans for the paint ResetISR() fills it with.  The firmware runs
+// on the host's own stack, so this one is painted once and reads as unused.
+#define STACK_WORDS             512
+static uint32_t g_pui32Stack[STACK_WORDS] __attribute__((used));
+__asm__(".globl __stack\n"
+        ".set __stack, g_pui32Stack\n"
+        ".globl __STACK_TOP\n"
+        ".set __STACK_TOP, g_pui32Stack + 2048\n");
+
+// Registers the firmware reads or writes with HWREG().  Anything not listed
+// in RegRefresh() simply holds what was last written.
+#define REG_COUNT               64
+
+typedef struct
+{
+    uint32_t ui32Addr;
+    volatile uint32_t ui32Value;
+} tSimReg;
+
+static tSimReg g_psRegs[REG_COUNT];
+static uint32_t g_ui32RegCount;
+
+// The NVIC.  Priorities are kept as written, with the lower value winning.
+// Thread mode runs at PRIO_THREAD, below every interrupt.
+#define PRIO_THREAD             0x100
+#define ACTIVE_DEPTH            16
+
+typedef void (*tSimHandler)(void);
+
+static tSimHandler g_ppfnVectors[NUM_INTERRUPTS];
+static uint8_t g_pui8Priority[NUM_INTERRUPTS];
+static bool g_pbEnabled[NUM_INTERRUPTS];
+static bool g_pbPending[NUM_INTERRUPTS];
+static uint32_t g_pui32Taken[NUM_INTERRUPTS];
+static bool g_pbActive[NUM_INTERRUPTS];
+static uint32_t g_pui32Active[ACTIVE_DEPTH];
+static uint32_t g_ui32ActiveDepth;
+static uint32_t g_ui32BasePri;
+static bool g_bPrimask = true;
+
+// SysTick.  The counter is worked out from the time its current period
+// started.
+static uint32_t g_ui32SysTickPeriod = 0x1000000;
+static bool g_bSysTickRunning;
+static bool g_bSysTickInt;
+static uint64_t g_ui64SysTickStart;
+
+// Start of the next USB frame.
+static uint64_t g_ui64FrameNext;
+
+// The host clock at the start of the simulation, the cycle counter value
+// last read and the offset from HostSimCycles() the firmware set by writing
+// DWT_CYCCNT.
+static struct timespec g_sTimeStart;
+static uint32_t g_ui32CycleLast;
+static uint32_t g_ui32CycleOffset;
+
+// Run state.
+static jmp_buf g_sRunExit;
+static tHostSimIdle g_pfnIdle;
+static bool g_bInIdle;
+static uint64_t g_ui64IdleNs;
+static uint64_t g_ui64IdleStart;
+
+// The event register WFE waits on, set whenever an interrupt becomes pending.
+static bool g_bEvent;
+
+// The virtual clock, once the bench has set it, and whether interrupts are
+// being held off.
+static bool g_bVirtualTime;
+static uint64_t g_ui64VirtualNs;
+static bool g_bHold;
+
+static void Dispatch(void);
+static void UARTAssertAll(void);
+static void UARTUpdateAll(void);
+static bool g_bConsole;
+
+// Pins of each GPIO port, as last written.
+static uint8_t g_pui8GPIOData[6];
+
+// Time on the host's monotonic clock, which the firmware's cost is measured
+// on whether or not the simulated clock is virtual.
+static uint64_t HostNs(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return(((uint64_t)(sNow.tv_sec - g_sTimeStart.tv_sec) * 1000000000) +
+           sNow.tv_nsec - g_sTimeStart.tv_nsec);
+}
+
+uint64_t HostSimTimeNs(void)
+{
+    return(g_bVirtualTime ? g_ui64VirtualNs : HostNs());
+}
+
+void HostSimTimeSet(uint64_t ui64Ns)
+{
+    if(!g_bVirtualTime || (ui64Ns > g_ui64VirtualNs))
+    {
+        g_ui64VirtualNs = ui64Ns;
+    }
+    g_bVirtualTime = true;
+}
+
+void HostSimHold(bool bHold)
+{
+    g_bHold = bHold;
+    if(!bHold)
+    {
+        Dispatch();
+    }
+}
+
+uint32_t HostSimCycles(void)
+{
+    return((uint32_t)((HostSimTimeNs() * (HOSTSIM_CLOCK_HZ / 1000000)) /
+                      1000));
+}
+
+uint32_t HostSimProfileNs(void)
+{
+    return((uint32_t)HostNs());
+}
+
+uint64_t HostSimFirmwareNs(void)
+{
+    uint64_t ui64Now, ui64Idle;
+
+    // Read the clock once, so that the time cannot go back between two calls
+    // in the same wait.
+    ui64Now = HostNs();
+    ui64Idle = g_ui64IdleNs;
+    if(g_bInIdle)
+    {
+        ui64Idle += ui64Now - g_ui64IdleStart;
+    }
+    return(ui64Now - ui64Idle);
+}
+
+uint32_t HostSimInterrupts(uint32_t ui32Int)
+{
+    return(g_pui32Taken[ui32Int]);
+}
+
+void HostSimConsole(bool bEnable)
+{
+    g_bConsole = bEnable;
+}
+
+// Nanoseconds in one SysTick period.
+static uint64_t SysTickPeriodNs(void)
+{
+    return(((uint64_t)g_ui32SysTickPeriod * 1000000000) / HOSTSIM_CLOCK_HZ);
+}
+
+// Return true if SysTick has counted down to zero since its interrupt was
+// last taken.
+static bool SysTickWrapped(void)
+{
+    return(g_bSysTickRunning &&
+           ((HostSimTimeNs() - g_ui64SysTickStart) >= SysTickPeriodNs()));
+}
+
+// Bring the registers with live values up to date.
+static void RegRefresh(tSimReg *psReg)
+{
+    uint32_t ui32Cycles;
+
+    switch(psReg->ui32Addr)
+    {
+        case NVIC_INT_CTRL:
+        {
+            psReg->ui32Value = (g_pbPending[FAULT_SYSTICK] || SysTickWrapped()) ?
+                               NVIC_INT_CTRL_PEND_STSET : 0;
+            break;
+        }
+        case SYSCTL_PLLSTAT:
+        {
+            psReg->ui32Value = SYSCTL_PLLSTAT_LOCK;
+            break;
+        }
+        case DWT_CYCCNT:
+        {
+            // A write since the last read restarts the count from the value
+            // written.
+            ui32Cycles = HostSimCycles();
+            if(psReg->ui32Value != g_ui32CycleLast)
+            {
+                g_ui32CycleOffset = ui32Cycles - psReg->ui32Value;
+            }
+            psReg->ui32Value = ui32Cycles - g_ui32CycleOffset;
+            g_ui32CycleLast = psReg->ui32Value;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+volatile uint32_t *HostSimReg(uint32_t ui32Addr)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_ui32RegCount; ui32Idx++)
+    {
+        if(g_psRegs[ui32Idx].ui32Addr == ui32Addr)
+        {
+            break;
+        }
+    }
+    if(ui32Idx == g_ui32RegCount)
+    {
+        if(g_ui32RegCount == REG_COUNT)
+        {
+            fprintf(stderr, "hostsim: too many registers at 0x%08x\n",
+                    ui32Addr);
+            abort();
+        }
+        g_psRegs[g_ui32RegCount].ui32Addr = ui32Addr;
+        g_psRegs[g_ui32RegCount].ui32Value = 0;
+        g_ui32RegCount++;
+    }
+
+    RegRefresh(&g_psRegs[ui32Idx]);
+    return(&g_psRegs[ui32Idx].ui32Value);
+}
+
+// The priority the processor runs at: that of the innermost active handler,
+// or BASEPRI if it is set and higher.
+static uint32_t ExecutionPriority(void)
+{
+    uint32_t ui32Prio;
+
+    ui32Prio = g_ui32ActiveDepth ? g_pui32Active[g_ui32ActiveDepth - 1] :
+               PRIO_THREAD;
+    if(g_ui32BasePri && (g_ui32BasePri < ui32Prio))
+    {
+        ui32Prio = g_ui32BasePri;
+    }
+    return(ui32Prio);
+}
+
+// Take pending interrupts, highest priority first and the lowest number
+// among equals, for as long as one can preempt what is running.
+static void Dispatch(void)
+{
+    uint32_t ui32Int, ui32Best;
+    uint64_t ui64Start;
+    bool bIdle;
+
+    while(!g_bPrimask && !g_bHold)
+    {
+        ui32Best = NUM_INTERRUPTS;
+        for(ui32Int = FAULT_PENDSV; ui32Int < NUM_INTERRUPTS; ui32Int++)
+        {
+            if(g_pbPending[ui32Int] &&
+               ((ui32Int < 16) || g_pbEnabled[ui32Int]) &&
+               ((ui32Best == NUM_INTERRUPTS) ||
+                (g_pui8Priority[ui32Int] < g_pui8Priority[ui32Best])))
+            {
+                ui32Best = ui32Int;
+            }
+        }
+        if((ui32Best == NUM_INTERRUPTS) ||
+           (g_pui8Priority[ui32Best] >= ExecutionPriority()))
+        {
+            return;
+        }
+
+        if(g_ui32ActiveDepth == ACTIVE_DEPTH)
+        {
+            fprintf(stderr, "hostsim: interrupts nested too deeply\n");
+            abort();
+        }
+
+        // A handler taken from the idle hook is firmware time.
+        bIdle = g_bInIdle;
+        ui64Start = HostNs();
+
+        g_pbPending[ui32Best] = false;
+        g_pui32Taken[ui32Best]++;
+        if(ui32Best == FAULT_SYSTICK)
+        {
+            g_ui64SysTickStart += SysTickPeriodNs() *
+                                  ((HostSimTimeNs() - g_ui64SysTickStart) /
+                                   SysTickPeriodNs());
+        }
+        g_pui32Active[g_ui32ActiveDepth++] = g_pui8Priority[ui32Best];
+        if(!g_ppfnVectors[ui32Best])
+        {
+            fprintf(stderr, "hostsim: unexpected interrupt %u\n", ui32Best);
+            abort();
+        }
+        g_pbActive[ui32Best] = true;
+        g_ppfnVectors[ui32Best]();
+        g_pbActive[ui32Best] = false;
+        g_ui32ActiveDepth--;
+        UARTAssertAll();
+
+        if(bIdle && !g_ui32ActiveDepth)
+        {
+            g_ui64IdleNs -= HostNs() - ui64Start;
+        }
+    }
+}
+
+void HostSimIntTrigger(uint32_t ui32Int)
+{
+    g_pbPending[ui32Int] = true;
+    g_bEvent = true;
+    Dispatch();
+}
+
+void HostSimPoll(void)
+{
+    uint64_t ui64Now;
+
+    ui64Now = HostSimTimeNs();
+    if(g_bSysTickInt && SysTickWrapped())
+    {
+        g_pbPending[FAULT_SYSTICK] = true;
+        g_bEvent = true;
+    }
+    if(ui64Now >= g_ui64FrameNext)
+    {
+        g_ui64FrameNext = ui64Now - (ui64Now % 1000000) + 1000000;
+        HostSimUSBFrame();
+    }
+    UARTUpdateAll();
+    Dispatch();
+}
+
+// The firmware is waiting for an interrupt: play the host until one comes
+// in.  WFE returns at once if one has come in since the last wait, as the
+// event register is already set; WFI and the sleep modes always wait.  An
+// interrupt that cannot be taken because it is masked still ends the wait.
+static void Idle(bool bEvent)
+{
+    bool bRun;
+
+    if(!bEvent)
+    {
+        g_bEvent = false;
+    }
+
+    // The whole wait is idle time, apart from the handlers run in it.
+    g_bInIdle = true;
+    g_ui64IdleStart = HostNs();
+    bRun = true;
+    while(!g_bEvent && bRun)
+    {
+        HostSimPoll();
+        if(!g_bEvent)
+        {
+            bRun = g_pfnIdle();
+        }
+    }
+    g_ui64IdleNs += HostNs() - g_ui64IdleStart;
+    g_bInIdle = false;
+    g_bEvent = false;
+
+    if(!bRun)
+    {
+        longjmp(g_sRunExit, 1);
+    }
+}
+
+void HostSimAsm(const char *pcInsn)
+{
+    if(strstr(pcInsn, "wfe"))
+    {
+        Idle(true);
+    }
+    else if(strstr(pcInsn, "wfi"))
+    {
+        Idle(false);
+    }
+}
+
+void HostSimRun(int (*pfnMain)(void), tHostSimIdle pfnIdle)
+{
+    uint32_t ui32Word;
+
+    clock_gettime(CLOCK_MONOTONIC, &g_sTimeStart);
+    g_ui64FrameNext = 1000000;
+    g_pfnIdle = pfnIdle;
+
+    // The vector table of startup_ccs.c.
+    g_ppfnVectors[FAULT_PENDSV] = USBUARTDeferredIntHandler;
+    g_ppfnVectors[FAULT_SYSTICK] = USBTickHandler;
+    g_ppfnVectors[INT_GPIOB] = USBUARTFlowIntHandler;
+    g_ppfnVectors[INT_GPIOD] = USBUARTFlowIntHandler;
+    g_ppfnVectors[INT_GPIOE] = USBUARTFlowIntHandler;
+    g_ppfnVectors[INT_UART0] = USBUARTIntHandler;
+    g_ppfnVectors[INT_UART1] = USBUARTPort1IntHandler;
+    g_ppfnVectors[INT_UART3] = USBUARTPort2IntHandler;
+    g_ppfnVectors[INT_TIMER0A] = USBLatencyUSBIntHandler;
+    g_ppfnVectors[INT_TIMER1A] = USBLatencyUARTIntHandler;
+    g_ppfnVectors[INT_USB0] = USB0DeviceIntHandler;
+
+    // The boot code paints the stack and enables interrupts before main() is
+    // called.
+    for(ui32Word = 0; ui32Word < STACK_WORDS; ui32Word++)
+    {
+        g_pui32Stack[ui32Word] = USB_STACK_PAINT;
+    }
+    g_bPrimask = false;
+
+    if(!setjmp(g_sRunExit))
+    {
+        pfnMain();
+    }
+}
+
+//
+// driverlib/interrupt.h
+//
+bool IntMasterEnable(void)
+{
+    bool bWas;
+
+    bWas = g_bPrimask;
+    g_bPrimask = false;
+    Dispatch();
+    return(bWas);
+}
+
+bool IntMasterDisable(void)
+{
+    bool bWas;
+
+    bWas = g_bPrimask;
+    g_bPrimask = true;
+    return(bWas);
+}
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+    g_pbEnabled[ui32Interrupt] = true;
+    Dispatch();
+}
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+    g_pbEnabled[ui32Interrupt] = false;
+}
+
+void IntPendSet(uint32_t ui32Interrupt)
+{
+    HostSimIntTrigger(ui32Interrupt);
+}
+
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority)
+{
+    g_pui8Priority[ui32Interrupt] = ui8Priority & 0xe0;
+}
+
+void IntPriorityMaskSet(uint32_t ui32PriorityMask)
+{
+    g_ui32BasePri = ui32PriorityMask & 0xe0;
+    Dispatch();
+}
+
+uint32_t IntPriorityMaskGet(void)
+{
+    return(g_ui32BasePri);
+}
+
+//
+// driverlib/systick.h
+//
+void SysTickEnable(void)
+{
+    g_bSysTickRunning = true;
+    g_ui64SysTickStart = HostSimTimeNs();
+}
+
+void SysTickDisable(void)
+{
+    g_bSysTickRunning = false;
+}
+
+void SysTickIntEnable(void)
+{
+    g_bSysTickInt = true;
+}
+
+void SysTickPeriodSet(uint32_t ui32Period)
+{
+    g_ui32SysTickPeriod = ui32Period;
+}
+
+uint32_t SysTickValueGet(void)
+{
+    uint64_t ui64Elapsed;
+
+    if(!g_bSysTickRunning)
+    {
+        return(g_ui32SysTickPeriod - 1);
+    }
+
+    // The counter reloads and carries on while the interrupt waits.
+    ui64Elapsed = (HostSimTimeNs() - g_ui64SysTickStart) % SysTickPeriodNs();
+    return(g_ui32SysTickPeriod - 1 -
+           (uint32_t)((ui64Elapsed * (HOSTSIM_CLOCK_HZ / 1000000)) / 1000));
+}
+
+//
+// driverlib/sysctl.h
+//
+void SysCtlClockSet(uint32_t ui32Config)
+{
+}
+
+uint32_t SysCtlClockGet(void)
+{
+    return(HOSTSIM_CLOCK_HZ);
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+}
+
+void SysCtlPeripheralSleepEnable(uint32_t ui32Peripheral)
+{
+}
+
+void SysCtlPeripheralDeepSleepEnable(uint32_t ui32Peripheral)
+{
+}
+
+void SysCtlPeripheralClockGating(bool bEnable)
+{
+}
+
+void SysCtlDeepSleepClockSet(uint32_t ui32Config)
+{
+}
+
+// Sleeping with interrupts masked still wakes on a pending interrupt, which
+// is then taken once they are unmasked.
+void SysCtlSleep(void)
+{
+    Idle(false);
+}
+
+void SysCtlDeepSleep(void)
+{
+    Idle(false);
+}
+
+//
+// driverlib/gpio.h
+//
+static uint8_t *GPIOData(uint32_t ui32Port)
+{
+    switch(ui32Port)
+    {
+        case GPIO_PORTA_BASE: return(&g_pui8GPIOData[0]);
+        case GPIO_PORTB_BASE: return(&g_pui8GPIOData[1]);
+        case GPIO_PORTC_BASE: return(&g_pui8GPIOData[2]);
+        case GPIO_PORTD_BASE: return(&g_pui8GPIOData[3]);
+        case GPIO_PORTE_BASE: return(&g_pui8GPIOData[4]);
+        default: return(&g_pui8GPIOData[5]);
+    }
+}
+
+void GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+}
+
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+void GPIOPinTypeUSBAnalog(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins,
+                      uint32_t ui32Strength, uint32_t ui32PadType)
+{
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint8_t *pui8Data;
+
+    pui8Data = GPIOData(ui32Port);
+    *pui8Data = (*pui8Data & ~ui8Pins) | (ui8Val & ui8Pins);
+}
+
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    return(*GPIOData(ui32Port) & ui8Pins);
+}
+
+void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType)
+{
+}
+
+void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+}
+
+void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+}
+
+uint32_t GPIOIntStatus(uint32_t ui32Port, bool bMasked)
+{
+    return(0);
+}
+
+//
+// driverlib/timer.h.  The timers are configured but never run.
+//
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+}
+
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+}
+
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+}
+
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+}
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+}
+
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    return(0);
+}
+
+//
+// driverlib/uart.h.  Each UART has 16 entry FIFOs and sends a character every
+// character time at the rate it was configured for.  Its TX line is looped
+// back to its RX line, so a bridge echoes what the host sends as the plain
+// firmware does.  The RX interrupt is raised when the RX FIFO fills to its
+// trigger level, the receive timeout when data has sat in it for 32 bit
+// times and the TX interrupt when the TX FIFO drains to its trigger level.
+// The interrupt line stays asserted while a raised interrupt is enabled.
+//
+#define UART_COUNT              4
+#define UART_FIFO_SIZE          16
+
+typedef struct
+{
+    uint32_t ui32Int;
+    uint64_t ui64CharNs;
+    uint32_t ui32TxTrigger;
+    uint32_t ui32RxTrigger;
+    uint32_t ui32IM;
+    uint32_t ui32RIS;
+    bool bDMATx;
+
+    // The TX FIFO and the character being shifted out.
+    uint8_t pui8Tx[UART_FIFO_SIZE];
+    uint32_t ui32TxRead;
+    uint32_t ui32TxCount;
+    bool bShifting;
+    uint8_t ui8Shift;
+    uint64_t ui64ShiftDone;
+
+    // The RX FIFO with the error bits of each character, and when the last
+    // character arrived.
+    uint16_t pui16Rx[UART_FIFO_SIZE];
+    uint32_t ui32RxRead;
+    uint32_t ui32RxCount;
+    bool bOverrun;
+    bool bTimeout;
+    uint64_t ui64RxLast;
+
+    // The uDMA channel feeding the TX FIFO, or -1.
+    int32_t i32DMAChannel;
+
+    // The rate and format last set, for UARTConfigGetExpClk().
+    uint32_t ui32Baud;
+    uint32_t ui32Config;
+} tSimUART;
+
+static tSimUART g_psUARTs[UART_COUNT] =
+{
+    { INT_UART0, 0, 8, 8, 0, 0, false, {0}, 0, 0, false, 0, 0, {0}, 0, 0,
+      false, false, 0, -1 },
+    { INT_UART1, 0, 8, 8, 0, 0, false, {0}, 0, 0, false, 0, 0, {0}, 0, 0,
+      false, false, 0, -1 },
+    { 0, 0, 8, 8, 0, 0, false, {0}, 0, 0, false, 0, 0, {0}, 0, 0,
+      false, false, 0, -1 },
+    { INT_UART3, 0, 8, 8, 0, 0, false, {0}, 0, 0, false, 0, 0, {0}, 0, 0,
+      false, false, 0, -1 },
+};
+
+// The uDMA channels.  Only basic transfers from memory to a UART's data
+// register are modelled.
+#define DMA_CHANNELS            32
+
+typedef struct
+{
+    bool bEnabled;
+    const uint8_t *pui8Src;
+    uint32_t ui32Count;
+    uint32_t ui32UART;
+} tSimDMA;
+
+static tSimDMA g_psDMA[DMA_CHANNELS];
+
+static tSimUART *UART(uint32_t ui32Base)
+{
+    return(&g_psUARTs[((ui32Base - UART0_BASE) >> 12) & (UART_COUNT - 1)]);
+}
+
+// Make an interrupt pending without taking it yet.
+static void Pend(uint32_t ui32Int)
+{
+    g_pbPending[ui32Int] = true;
+    g_bEvent = true;
+}
+
+// Assert the interrupt line of a UART if a raised interrupt is enabled.  An
+// interrupt that is being handled is made pending again, if still asserted,
+// when its handler returns.
+static void UARTAssert(tSimUART *psUART)
+{
+    if(psUART->ui32Int && (psUART->ui32RIS & psUART->ui32IM) &&
+       !g_pbActive[psUART->ui32Int])
+    {
+        Pend(psUART->ui32Int);
+    }
+}
+
+static void UARTAssertAll(void)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < UART_COUNT; ui32Idx++)
+    {
+        UARTAssert(&g_psUARTs[ui32Idx]);
+    }
+}
+
+// Start shifting out the next character at time ui64Ns if the line is idle.
+static void UARTTxNext(tSimUART *psUART, uint64_t ui64Ns)
+{
+    if(psUART->bShifting || !psUART->ui32TxCount)
+    {
+        return;
+    }
+
+    if(psUART->ui32TxCount == (psUART->ui32TxTrigger + 1))
+    {
+        psUART->ui32RIS |= UART_INT_TX;
+    }
+    psUART->ui8Shift = psUART->pui8Tx[psUART->ui32TxRead];
+    psUART->ui32TxRead = (psUART->ui32TxRead + 1) % UART_FIFO_SIZE;
+    psUART->ui32TxCount--;
+    psUART->bShifting = true;
+    psUART->ui64ShiftDone = ui64Ns + psUART->ui64CharNs;
+}
+
+static bool UARTTxPush(tSimUART *psUART, uint8_t ui8Data, uint64_t ui64Ns)
+{
+    if(psUART->ui32TxCount == UART_FIFO_SIZE)
+    {
+        return(false);
+    }
+    psUART->pui8Tx[(psUART->ui32TxRead + psUART->ui32TxCount) %
+                   UART_FIFO_SIZE] = ui8Data;
+    psUART->ui32TxCount++;
+    UARTTxNext(psUART, ui64Ns);
+    return(true);
+}
+
+// The uDMA channel answers the UART's requests for as long as the TX FIFO
+// has room, and signals the end of the transfer on the UART's interrupt.
+static void UARTDMAFill(tSimUART *psUART, uint64_t ui64Ns)
+{
+    tSimDMA *psDMA;
+
+    if(!psUART->bDMATx || (psUART->i32DMAChannel < 0))
+    {
+        return;
+    }
+    psDMA = &g_psDMA[psUART->i32DMAChannel];
+    if(!psDMA->bEnabled)
+    {
+        return;
+    }
+
+    while(psDMA->ui32Count && UARTTxPush(psUART, *psDMA->pui8Src, ui64Ns))
+    {
+        psDMA->pui8Src++;
+        psDMA->ui32Count--;
+    }
+    if(!psDMA->ui32Count)
+    {
+        psDMA->bEnabled = false;
+        Pend(psUART->ui32Int);
+    }
+}
+
+static void UARTRxPush(tSimUART *psUART, uint8_t ui8Data, uint64_t ui64Ns)
+{
+    if(psUART->ui32RxCount == UART_FIFO_SIZE)
+    {
+        psUART->bOverrun = true;
+        return;
+    }
+    psUART->pui16Rx[(psUART->ui32RxRead + psUART->ui32RxCount) %
+                    UART_FIFO_SIZE] = ui8Data |
+                                      (psUART->bOverrun ? UART_DR_OE : 0);
+    psUART->bOverrun = false;
+    psUART->ui32RxCount++;
+    psUART->ui64RxLast = ui64Ns;
+    psUART->bTimeout = false;
+    if(psUART->ui32RxCount == psUART->ui32RxTrigger)
+    {
+        psUART->ui32RIS |= UART_INT_RX;
+    }
+}
+
+// Bring a UART up to the present: finish the characters whose time is up,
+// loop them back and start the next ones.
+static void UARTUpdate(tSimUART *psUART)
+{
+    uint64_t ui64Now, ui64Ns;
+
+    if(!psUART->ui64CharNs)
+    {
+        return;
+    }
+
+    ui64Now = HostSimTimeNs();
+    UARTDMAFill(psUART, ui64Now);
+    while(psUART->bShifting && (psUART->ui64ShiftDone <= ui64Now))
+    {
+        ui64Ns = psUART->ui64ShiftDone;
+        psUART->bShifting = false;
+        UARTRxPush(psUART, psUART->ui8Shift, ui64Ns);
+        UARTTxNext(psUART, ui64Ns);
+        UARTDMAFill(psUART, ui64Ns);
+    }
+
+    if(psUART->ui32RxCount && !psUART->bTimeout &&
+       (ui64Now >= (psUART->ui64RxLast + ((psUART->ui64CharNs * 32) / 10))))
+    {
+        psUART->bTimeout = true;
+        psUART->ui32RIS |= UART_INT_RT;
+    }
+    UARTAssert(psUART);
+}
+
+static void UARTUpdateAll(void)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < UART_COUNT; ui32Idx++)
+    {
+        UARTUpdate(&g_psUARTs[ui32Idx]);
+    }
+}
+
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                         uint32_t ui32Baud, uint32_t ui32Config)
+{
+    uint32_t ui32Bits;
+
+    if(ui32Baud > (ui32UARTClk / 16))
+    {
+        ui32Baud = ui32UARTClk / 16;
+    }
+
+    // Start, data, parity and stop bits.
+    ui32Bits = 1 + 5 + ((ui32Config >> 5) & 3) +
+               ((ui32Config & UART_CONFIG_PAR_ODD) ? 1 : 0) +
+               ((ui32Config & UART_CONFIG_STOP_TWO) ? 2 : 1);
+    UART(ui32Base)->ui64CharNs = ((uint64_t)ui32Bits * 1000000000) / ui32Baud;
+    UART(ui32Base)->ui32Baud = ui32Baud;
+    UART(ui32Base)->ui32Config = ui32Config;
+}
+
+void UARTConfigGetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk,
+                         uint32_t *pui32Baud, uint32_t *pui32Config)
+{
+    *pui32Baud = UART(ui32Base)->ui32Baud;
+    *pui32Config = UART(ui32Base)->ui32Config;
+}
+
+void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                      uint32_t ui32RxLevel)
+{
+    static const uint8_t pui8Levels[] = { 2, 4, 8, 12, 14 };
+
+    UART(ui32Base)->ui32TxTrigger = pui8Levels[ui32TxLevel % 5];
+    UART(ui32Base)->ui32RxTrigger = pui8Levels[(ui32RxLevel >> 3) % 5];
+}
+
+void UARTTxIntModeSet(uint32_t ui32Base, uint32_t ui32Mode)
+{
+}
+
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+}
+
+void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    UART(ui32Base)->ui32IM |= ui32IntFlags;
+    UARTUpdate(UART(ui32Base));
+    Dispatch();
+}
+
+void UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    UART(ui32Base)->ui32IM &= ~ui32IntFlags;
+}
+
+void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    UART(ui32Base)->ui32RIS &= ~ui32IntFlags;
+}
+
+uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    UARTUpdate(UART(ui32Base));
+    return(UART(ui32Base)->ui32RIS &
+           (bMasked ? UART(ui32Base)->ui32IM : 0xffffffff));
+}
+
+void UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    if(ui32DMAFlags & UART_DMA_TX)
+    {
+        UART(ui32Base)->bDMATx = true;
+    }
+}
+
+bool UARTSpaceAvail(uint32_t ui32Base)
+{
+    UARTUpdate(UART(ui32Base));
+    return(UART(ui32Base)->ui32TxCount < UART_FIFO_SIZE);
+}
+
+bool UARTCharsAvail(uint32_t ui32Base)
+{
+    UARTUpdate(UART(ui32Base));
+    return(UART(ui32Base)->ui32RxCount != 0);
+}
+
+bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    UARTUpdate(UART(ui32Base));
+    return(UARTTxPush(UART(ui32Base), ucData, HostSimTimeNs()));
+}
+
+int32_t UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    tSimUART *psUART;
+    int32_t i32Data;
+
+    psUART = UART(ui32Base);
+    UARTUpdate(psUART);
+    if(!psUART->ui32RxCount)
+    {
+        return(-1);
+    }
+    i32Data = psUART->pui16Rx[psUART->ui32RxRead];
+    psUART->ui32RxRead = (psUART->ui32RxRead + 1) % UART_FIFO_SIZE;
+    psUART->ui32RxCount--;
+    return(i32Data);
+}
+
+bool UARTBusy(uint32_t ui32Base)
+{
+    UARTUpdate(UART(ui32Base));
+    return(UART(ui32Base)->bShifting || UART(ui32Base)->ui32TxCount);
+}
+
+//
+// driverlib/udma.h
+//
+void uDMAEnable(void)
+{
+}
+
+void uDMAControlBaseSet(void *pControlTable)
+{
+}
+
+void uDMAChannelAssign(uint32_t ui32Mapping)
+{
+}
+
+void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+}
+
+void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex,
+                           uint32_t ui32Control)
+{
+}
+
+void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                            void *pvSrcAddr, void *pvDstAddr,
+                            uint32_t ui32TransferSize)
+{
+    tSimDMA *psDMA;
+    uint32_t ui32UART;
+
+    psDMA = &g_psDMA[ui32ChannelStructIndex & (DMA_CHANNELS - 1)];
+    ui32UART = (((uint32_t)(uintptr_t)pvDstAddr - UART_O_DR - UART0_BASE) >>
+                12) & (UART_COUNT - 1);
+    psDMA->pui8Src = pvSrcAddr;
+    psDMA->ui32Count = ui32TransferSize;
+    psDMA->ui32UART = ui32UART;
+    g_psUARTs[ui32UART].i32DMAChannel =
+        ui32ChannelStructIndex & (DMA_CHANNELS - 1);
+}
+
+void uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    tSimDMA *psDMA;
+
+    psDMA = &g_psDMA[ui32ChannelNum & (DMA_CHANNELS - 1)];
+    psDMA->bEnabled = true;
+    UARTUpdate(&g_psUARTs[psDMA->ui32UART]);
+    Dispatch();
+}
+
+void uDMAChannelDisable(uint32_t ui32ChannelNum)
+{
+    g_psDMA[ui32ChannelNum & (DMA_CHANNELS - 1)].bEnabled = false;
+}
+
+bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+    tSimDMA *psDMA;
+
+    psDMA = &g_psDMA[ui32ChannelNum & (DMA_CHANNELS - 1)];
+    UARTUpdate(&g_psUARTs[psDMA->ui32UART]);
+    return(psDMA->bEnabled);
+}
+
+uint32_t uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex)
+{
+    tSimDMA *psDMA;
+
+    psDMA = &g_psDMA[ui32ChannelStructIndex & (DMA_CHANNELS - 1)];
+    UARTUpdate(&g_psUARTs[psDMA->ui32UART]);
+    return(psDMA->ui32Count);
+}
+
+//
+// utils/uartstdio.h
+//
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud,
+                     uint32_t ui32SrcClock)
+{
+}
+
+void UARTprintf(const char *pcString, ...)
+{
+    va_list vaArgs;
+
+    if(g_bConsole)
+    {
+        va_start(vaArgs, pcString);
+        vfprintf(stderr, pcString, vaArgs);
+        va_end(vaArgs);
+    }
+}
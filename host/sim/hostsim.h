@@ -0,0 +1,128 @@
+/*
+ * hostsim.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host simulation of the parts of the TM4C123 the driver runs on: the NVIC,
+// SysTick, the registers the driver touches directly and the USB controller
+// as seen through usblib.  The firmware sources are compiled unchanged
+// against the stand-in headers in this directory, with main() renamed to
+// FirmwareMain(), and run on the host thread.  Interrupt handlers are called
+// from the points where the firmware changes the interrupt state (pending an
+// interrupt, lowering BASEPRI or PRIMASK) and whenever the firmware waits
+// for an interrupt, so a handler never preempts code in the middle of a
+// statement, but priorities, masking and tail-chaining behave as on the
+// target.
+//
+// The bench supplies an idle hook that plays the host: every time the main
+// loop sleeps the hook is called to move packets over the simulated bus.
+
+#ifndef __HOSTSIM_H__
+#define __HOSTSIM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The system clock the firmware is told it runs at.
+#define HOSTSIM_CLOCK_HZ        50000000
+
+// Called whenever the firmware waits for an interrupt.  Returning false ends
+// HostSimRun().
+typedef bool (*tHostSimIdle)(void);
+
+//
+// Used by the stand-in headers.
+//
+extern volatile uint32_t *HostSimReg(uint32_t ui32Addr);
+extern void HostSimAsm(const char *pcInsn);
+
+//
+// Simulation control, used by the benches.
+//
+// Run the firmware's main() until the idle hook returns false.
+extern void HostSimRun(int (*pfnMain)(void), tHostSimIdle pfnIdle);
+
+// Nanoseconds since the simulation started.  This is the host's monotonic
+// clock unless the bench has set the time itself with HostSimTimeSet(), and
+// is what SysTick, the USB frames and the cycle counter run on.
+extern uint64_t HostSimTimeNs(void);
+
+// Switch to a virtual clock, or move it on, to run the firmware against a
+// model of the bus or the UART line rather than as fast as the host can go.
+// The clock never goes back.
+extern void HostSimTimeSet(uint64_t ui64Ns);
+
+// Hold off all interrupts, as if the processor were still busy, or take the
+// ones that came in meanwhile.
+extern void HostSimHold(bool bHold);
+
+// The same time counted in cycles of the simulated system clock.  This is
+// what the DWT cycle counter reads.
+extern uint32_t HostSimCycles(void);
+
+// Nanoseconds on the host's monotonic clock, even once the bench has set
+// the time itself.  The profile build reads this in place of the cycle
+// counter (USB_PROFILE_TIMESTAMP in usbprofile.h), so that the probes time
+// the firmware on the host rather than the simulated clock.
+extern uint32_t HostSimProfileNs(void);
+
+// Take any SysTick or USB frame interrupt that has come due.  HostSimRun()
+// does this before every call of the idle hook.
+extern void HostSimPoll(void);
+
+// Time on the host's clock spent outside the idle hook, that is in the
+// firmware and the simulated hardware, and the number of interrupt handlers
+// run.
+extern uint64_t HostSimFirmwareNs(void);
+extern uint32_t HostSimInterrupts(uint32_t ui32Int);
+
+// Send the uartstdio console to stderr instead of dropping it.
+extern void HostSimConsole(bool bEnable);
+
+// Make an interrupt pending and take it if nothing of a higher priority is
+// running.  Used by the peripheral models.
+extern void HostSimIntTrigger(uint32_t ui32Int);
+
+//
+// The host side of the USB bus, in usblib.c.
+//
+// Reset the device and set its configuration.  Each CDC function sees
+// USB_EVENT_CONNECTED.
+extern void HostSimUSBConfigure(void);
+
+// Suspend or resume the bus.
+extern void HostSimUSBSuspend(bool bSuspend);
+
+// Send one packet of up to 64 bytes to a port's bulk OUT endpoint.  Returns
+// false if the endpoint NAKed it because its FIFO is full.
+extern bool HostSimUSBOut(uint32_t ui32Port, const uint8_t *pui8Data,
+                          uint32_t ui32Size);
+
+// Collect one packet from a port's bulk IN endpoint into pui8Data, which must
+// hold 64 bytes.  Returns the packet size, which is 0 for a zero-length
+// packet, or -1 if the endpoint NAKed.
+extern int32_t HostSimUSBIn(uint32_t ui32Port, uint8_t *pui8Data);
+
+// Run a control transfer on endpoint 0.  For an OUT request pui8Data holds
+// the wLength bytes of the data stage, for an IN request it receives up to
+// wLength bytes.  Returns the bytes transferred in the data stage or -1 if
+// the device stalled the request.
+extern int32_t HostSimUSBControl(uint8_t ui8RequestType, uint8_t ui8Request,
+                                 uint16_t ui16Value, uint16_t ui16Index,
+                                 uint16_t ui16Length, uint8_t *pui8Data);
+
+// The serial state a port last sent on its notification endpoint and how
+// many notifications it has sent.
+extern uint16_t HostSimUSBSerialState(uint32_t ui32Port,
+                                      uint32_t *pui32Count);
+
+// Handle the USB controller's events.  Called by the interrupt handler the
+// simulated vector table points at.
+extern void USB0DeviceIntHandler(void);
+
+// A USB frame has started.  Called by HostSimPoll() once a millisecond.
+extern void HostSimUSBFrame(void);
+
+#endif // __HOSTSIM_H__
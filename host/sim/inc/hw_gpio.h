@@ -0,0 +1,13 @@
+/*
+ * hw_gpio.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_gpio.h.  Nothing in it is used.
+
+#ifndef __HW_GPIO_H__
+#define __HW_GPIO_H__
+
+#endif // __HW_GPIO_H__
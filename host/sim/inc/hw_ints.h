@@ -0,0 +1,29 @@
+/*
+ * hw_ints.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_ints.h (TM4C123 numbering).
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define FAULT_PENDSV            14
+#define FAULT_SYSTICK           15
+#define INT_GPIOA               16
+#define INT_GPIOB               17
+#define INT_GPIOC               18
+#define INT_GPIOD               19
+#define INT_GPIOE               20
+#define INT_UART0               21
+#define INT_UART1               22
+#define INT_TIMER0A             35
+#define INT_TIMER1A             37
+#define INT_GPIOF               46
+#define INT_USB0                60
+#define INT_UART3               75
+#define NUM_INTERRUPTS          155
+
+#endif // __HW_INTS_H__
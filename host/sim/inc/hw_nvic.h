@@ -0,0 +1,31 @@
+/*
+ * hw_nvic.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_nvic.h.
+
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+
+#define NVIC_ACTIVE0            0xE000E300
+#define NVIC_ACTIVE1            0xE000E304
+#define NVIC_ACTIVE2            0xE000E308
+#define NVIC_ACTIVE3            0xE000E30C
+#define NVIC_ACTIVE4            0xE000E310
+#define NVIC_INT_CTRL           0xE000ED04
+#define NVIC_SYS_HND_CTRL       0xE000ED24
+
+#define NVIC_INT_CTRL_PEND_STSET    0x04000000
+
+#define NVIC_SYS_HND_CTRL_TICK  0x00000800
+#define NVIC_SYS_HND_CTRL_PNDSV 0x00000400
+#define NVIC_SYS_HND_CTRL_MON   0x00000100
+#define NVIC_SYS_HND_CTRL_SVC   0x00000080
+#define NVIC_SYS_HND_CTRL_USGA  0x00000008
+#define NVIC_SYS_HND_CTRL_BUSA  0x00000002
+#define NVIC_SYS_HND_CTRL_MEMA  0x00000001
+
+#endif // __HW_NVIC_H__
@@ -0,0 +1,16 @@
+/*
+ * hw_sysctl.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_sysctl.h.
+
+#ifndef __HW_SYSCTL_H__
+#define __HW_SYSCTL_H__
+
+#define SYSCTL_PLLSTAT          0x400FE168
+#define SYSCTL_PLLSTAT_LOCK     0x00000001
+
+#endif // __HW_SYSCTL_H__
@@ -0,0 +1,36 @@
+/*
+ * hw_types.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_types.h.  Register accesses go to the
+// simulated register file in hostsim.c, and the TI compiler intrinsics and
+// inline assembly the driver uses are given host versions.
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hostsim.h"
+
+#define HWREG(x)                (*HostSimReg((uint32_t)(uintptr_t)(x)))
+
+// Every handler runs to completion on one thread, so an exclusive store can
+// never be interrupted and always succeeds.
+static inline uint32_t __ldrex(void *pvAddr)
+{
+    return(*(volatile uint32_t *)pvAddr);
+}
+
+static inline uint32_t __strex(uint32_t ui32Value, void *pvAddr)
+{
+    *(volatile uint32_t *)pvAddr = ui32Value;
+    return(0);
+}
+
+#define __asm(pcInsn)           HostSimAsm(pcInsn)
+
+#endif // __HW_TYPES_H__
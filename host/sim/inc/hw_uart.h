@@ -0,0 +1,20 @@
+/*
+ * hw_uart.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare inc/hw_uart.h.
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_DR               0x00000000
+
+#define UART_DR_OE              0x00000800
+#define UART_DR_BE              0x00000400
+#define UART_DR_PE              0x00000200
+#define UART_DR_FE              0x00000100
+
+#endif // __HW_UART_H__
@@ -0,0 +1,1153 @@
+/*
+ * usblib.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// The parts of TivaWare usblib the driver is built on, together with the USB
+// controller under them and the host on the other side of the bus.  The USB
+// buffer, the CDC class driver and the composite driver follow usblib's
+// behaviour where the driver depends on it:
+//
+// - A ring buffer always keeps one byte free.
+// - Data for the host stays in the transmit buffer until the packet carrying
+//   it has been collected, and the next packet is scheduled on
+//   USB_EVENT_TX_COMPLETE before the application hears of it.  A packet that
+//   wraps the end of the ring is written in two parts, and a zero-length
+//   packet follows a full one that empties the buffer when enabled.
+// - The CDC driver has one IN packet in flight at a time, and reports it
+//   sent once the endpoint can take the next one: at once if a
+//   double-buffered IN FIFO has the other half free.
+// - Each packet from the host raises USB_EVENT_RX_AVAILABLE.  The receive
+//   buffer reads as much of it as fits and the packet is only acknowledged
+//   once all of it has been read.  A packet left in the FIFO is offered again
+//   on the next frame.
+// - usblib programs single-packet FIFOs when the host sets the
+//   configuration.  A double-buffered FIFO holds two packets.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "hostsim.h"
+
+#define MAX_PACKET_SIZE         64
+#define NUM_ENDPOINTS           8
+#define MAX_PORTS               3
+
+// Standard requests handled by the device core.
+#define USBREQ_SET_CONFIG       0x09
+
+// Bits of the endpoint status passed to pfnEndpointHandler.
+#define EP_STATUS_IN(ui32EP)    (1 << ((ui32EP) >> 4))
+#define EP_STATUS_OUT(ui32EP)   (0x10000 << ((ui32EP) >> 4))
+
+//*****************************************************************************
+//
+// The USB controller.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint8_t pui8Data[MAX_PACKET_SIZE];
+    uint32_t ui32Size;
+} tSimPacket;
+
+typedef struct
+{
+    // Packets received from the host, oldest first, and how much of the
+    // oldest has been read.
+    tSimPacket psOut[2];
+    uint32_t ui32OutCount;
+    uint32_t ui32OutRead;
+    uint32_t ui32OutDepth;
+
+    // Packets loaded for the host, oldest first, with the one being loaded
+    // after them, and whether the last one loaded is waiting for room before
+    // it can be reported sent.
+    tSimPacket psIn[2];
+    uint32_t ui32InCount;
+    uint32_t ui32InDepth;
+    bool bInWaiting;
+} tSimEndpoint;
+
+static tSimEndpoint g_psEndpoints[NUM_ENDPOINTS];
+
+// Events the controller has raised and the USB interrupt has not handled
+// yet.
+static uint32_t g_ui32EPStatus;
+static bool g_bConfigEvent;
+static bool g_bSuspendEvent;
+static bool g_bResumeEvent;
+static bool g_bFrameEvent;
+
+// The control transfer in progress.
+static struct
+{
+    tUSBRequest sRequest;
+    uint8_t pui8Data[256];
+    bool bPending;
+    int32_t i32Result;
+} g_sEP0;
+
+// The device on the bus and its CDC functions in port order.
+static tDeviceInfo *g_psDevInfo;
+static void *g_pvDevInstance;
+static tUSBDCDCDevice *g_ppsPorts[MAX_PORTS];
+static uint32_t g_ui32NumPorts;
+static uint32_t g_pui32Notifications[MAX_PORTS];
+
+static tSimEndpoint *Endpoint(uint32_t ui32EP)
+{
+    return(&g_psEndpoints[(ui32EP >> 4) & (NUM_ENDPOINTS - 1)]);
+}
+
+void USBFIFOConfigSet(uint32_t ui32Base, uint32_t ui32Endpoint,
+                      uint32_t ui32FIFOAddress, uint32_t ui32FIFOSize,
+                      uint32_t ui32Flags)
+{
+    uint32_t ui32Depth;
+
+    ui32Depth = (ui32FIFOSize & USB_FIFO_SIZE_DB_FLAG) ? 2 : 1;
+    if(ui32Flags & USB_EP_DEV_IN)
+    {
+        Endpoint(ui32Endpoint)->ui32InDepth = ui32Depth;
+    }
+    else
+    {
+        Endpoint(ui32Endpoint)->ui32OutDepth = ui32Depth;
+    }
+}
+
+void USBFIFOFlush(uint32_t ui32Base, uint32_t ui32Endpoint, uint32_t ui32Flags)
+{
+    tSimEndpoint *psEP;
+
+    psEP = Endpoint(ui32Endpoint);
+    if(ui32Flags & USB_EP_DEV_IN)
+    {
+        psEP->ui32InCount = 0;
+        psEP->psIn[0].ui32Size = 0;
+        psEP->psIn[1].ui32Size = 0;
+        psEP->bInWaiting = false;
+    }
+    else
+    {
+        psEP->ui32OutCount = 0;
+        psEP->ui32OutRead = 0;
+    }
+}
+
+void USBDevEndpointDataAck(uint32_t ui32Base, uint32_t ui32Endpoint,
+                           bool bIsLastPacket)
+{
+    // Endpoint 0 requests without a data stage complete here.
+    if(ui32Endpoint == USB_EP_0)
+    {
+        g_sEP0.i32Result = 0;
+    }
+}
+
+void USBDCDSendDataEP0(uint32_t ui32Index, uint8_t *pui8Data,
+                       uint32_t ui32Size)
+{
+    if(ui32Size > g_sEP0.sRequest.wLength)
+    {
+        ui32Size = g_sEP0.sRequest.wLength;
+    }
+    memcpy(g_sEP0.pui8Data, pui8Data, ui32Size);
+    g_sEP0.i32Result = ui32Size;
+}
+
+void USBDCDStallEP0(uint32_t ui32Index)
+{
+    g_sEP0.i32Result = -1;
+}
+
+void USBStackModeSet(uint32_t ui32Index, tUSBMode iUSBMode,
+                     tUSBModeCallback pfnCallback)
+{
+}
+
+// Put a device on the bus.  Its handlers see every event from now on.
+static void DeviceConnect(tDeviceInfo *psDevInfo, void *pvInstance)
+{
+    g_psDevInfo = psDevInfo;
+    g_pvDevInstance = pvInstance;
+    IntEnable(INT_USB0);
+}
+
+// Run the control request in g_sEP0.  Setting the configuration is handled
+// here; everything else goes to the device's request handler.
+static void ControlRequest(void)
+{
+    const tCustomHandlers *psHandlers;
+    uint32_t ui32EP;
+
+    psHandlers = g_psDevInfo->psCallbacks;
+    g_sEP0.i32Result = -1;
+    if(((g_sEP0.sRequest.bmRequestType & USB_RTYPE_TYPE_M) ==
+        USB_RTYPE_STANDARD) &&
+       (g_sEP0.sRequest.bRequest == USBREQ_SET_CONFIG))
+    {
+        // Every data endpoint goes back to a single-packet FIFO.
+        for(ui32EP = 1; ui32EP < NUM_ENDPOINTS; ui32EP++)
+        {
+            g_psEndpoints[ui32EP].ui32OutDepth = 1;
+            g_psEndpoints[ui32EP].ui32InDepth = 1;
+        }
+        g_sEP0.i32Result = 0;
+        psHandlers->pfnConfigChange(g_pvDevInstance,
+                                    g_sEP0.sRequest.wValue);
+    }
+    else
+    {
+        psHandlers->pfnRequestHandler(g_pvDevInstance, &g_sEP0.sRequest);
+    }
+    g_sEP0.bPending = false;
+}
+
+static void CDCFrame(tUSBDCDCDevice *psCDCDevice);
+
+// The USB interrupt handler of usblib's device mode.
+void USB0DeviceIntHandler(void)
+{
+    const tCustomHandlers *psHandlers;
+    uint32_t ui32Status, ui32Port;
+
+    psHandlers = g_psDevInfo->psCallbacks;
+
+    if(g_bSuspendEvent)
+    {
+        g_bSuspendEvent = false;
+        psHandlers->pfnSuspendHandler(g_pvDevInstance);
+    }
+    if(g_bResumeEvent)
+    {
+        g_bResumeEvent = false;
+        psHandlers->pfnResumeHandler(g_pvDevInstance);
+    }
+    if(g_bConfigEvent || g_sEP0.bPending)
+    {
+        g_bConfigEvent = false;
+        ControlRequest();
+    }
+
+    ui32Status = g_ui32EPStatus;
+    g_ui32EPStatus = 0;
+    if(ui32Status)
+    {
+        psHandlers->pfnEndpointHandler(g_pvDevInstance, ui32Status);
+    }
+
+    if(g_bFrameEvent)
+    {
+        g_bFrameEvent = false;
+        for(ui32Port = 0; ui32Port < g_ui32NumPorts; ui32Port++)
+        {
+            CDCFrame(g_ppsPorts[ui32Port]);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// The host.
+//
+//*****************************************************************************
+void HostSimUSBConfigure(void)
+{
+    g_sEP0.sRequest.bmRequestType = USB_RTYPE_STANDARD | USB_RTYPE_DEVICE;
+    g_sEP0.sRequest.bRequest = USBREQ_SET_CONFIG;
+    g_sEP0.sRequest.wValue = 1;
+    g_sEP0.sRequest.wIndex = 0;
+    g_sEP0.sRequest.wLength = 0;
+    g_sEP0.bPending = true;
+    HostSimIntTrigger(INT_USB0);
+}
+
+void HostSimUSBSuspend(bool bSuspend)
+{
+    if(bSuspend)
+    {
+        g_bSuspendEvent = true;
+    }
+    else
+    {
+        g_bResumeEvent = true;
+    }
+    HostSimIntTrigger(INT_USB0);
+}
+
+void HostSimUSBFrame(void)
+{
+    if(g_psDevInfo)
+    {
+        g_bFrameEvent = true;
+        HostSimIntTrigger(INT_USB0);
+    }
+}
+
+bool HostSimUSBOut(uint32_t ui32Port, const uint8_t *pui8Data,
+                   uint32_t ui32Size)
+{
+    tSimEndpoint *psEP;
+    uint32_t ui32EP;
+
+    if(ui32Port >= g_ui32NumPorts)
+    {
+        return(false);
+    }
+    ui32EP = g_ppsPorts[ui32Port]->sPrivateData.ui8BulkOUTEndpoint;
+    psEP = Endpoint(ui32EP);
+    if(psEP->ui32OutCount >= psEP->ui32OutDepth)
+    {
+        return(false);
+    }
+
+    memcpy(psEP->psOut[psEP->ui32OutCount].pui8Data, pui8Data, ui32Size);
+    psEP->psOut[psEP->ui32OutCount].ui32Size = ui32Size;
+    psEP->ui32OutCount++;
+    g_ui32EPStatus |= EP_STATUS_OUT(ui32EP);
+    HostSimIntTrigger(INT_USB0);
+    return(true);
+}
+
+int32_t HostSimUSBIn(uint32_t ui32Port, uint8_t *pui8Data)
+{
+    tSimEndpoint *psEP;
+    uint32_t ui32EP;
+    int32_t i32Size;
+
+    if(ui32Port >= g_ui32NumPorts)
+    {
+        return(-1);
+    }
+    ui32EP = g_ppsPorts[ui32Port]->sPrivateData.ui8BulkINEndpoint;
+    psEP = Endpoint(ui32EP);
+    if(!psEP->ui32InCount)
+    {
+        return(-1);
+    }
+
+    i32Size = psEP->psIn[0].ui32Size;
+    memcpy(pui8Data, psEP->psIn[0].pui8Data, i32Size);
+    psEP->psIn[0] = psEP->psIn[1];
+    psEP->psIn[1].ui32Size = 0;
+    psEP->ui32InCount--;
+    if(psEP->bInWaiting)
+    {
+        psEP->bInWaiting = false;
+        g_ui32EPStatus |= EP_STATUS_IN(ui32EP);
+        HostSimIntTrigger(INT_USB0);
+    }
+    return(i32Size);
+}
+
+int32_t HostSimUSBControl(uint8_t ui8RequestType, uint8_t ui8Request,
+                          uint16_t ui16Value, uint16_t ui16Index,
+                          uint16_t ui16Length, uint8_t *pui8Data)
+{
+    if(ui16Length > sizeof(g_sEP0.pui8Data))
+    {
+        return(-1);
+    }
+
+    g_sEP0.sRequest.bmRequestType = ui8RequestType;
+    g_sEP0.sRequest.bRequest = ui8Request;
+    g_sEP0.sRequest.wValue = ui16Value;
+    g_sEP0.sRequest.wIndex = ui16Index;
+    g_sEP0.sRequest.wLength = ui16Length;
+    if(!(ui8RequestType & USB_RTYPE_DIR_IN) && ui16Length)
+    {
+        memcpy(g_sEP0.pui8Data, pui8Data, ui16Length);
+    }
+    g_sEP0.bPending = true;
+    HostSimIntTrigger(INT_USB0);
+
+    // The interrupt can only be held off if the host runs from inside the
+    // firmware's critical section, which the benches never do.
+    if(g_sEP0.bPending)
+    {
+        fprintf(stderr, "usblib: control request not taken\n");
+        return(-1);
+    }
+
+    if((ui8RequestType & USB_RTYPE_DIR_IN) && (g_sEP0.i32Result > 0))
+    {
+        memcpy(pui8Data, g_sEP0.pui8Data, g_sEP0.i32Result);
+    }
+    return(g_sEP0.i32Result);
+}
+
+uint16_t HostSimUSBSerialState(uint32_t ui32Port, uint32_t *pui32Count)
+{
+    if(pui32Count)
+    {
+        *pui32Count = g_pui32Notifications[ui32Port];
+    }
+    return(g_ppsPorts[ui32Port]->sPrivateData.ui16SerialState);
+}
+
+//*****************************************************************************
+//
+// The CDC class driver.
+//
+//*****************************************************************************
+static uint32_t PortFromInstance(tUSBDCDCDevice *psCDCDevice)
+{
+    uint32_t ui32Port;
+
+    for(ui32Port = 0; ui32Port < g_ui32NumPorts; ui32Port++)
+    {
+        if(g_ppsPorts[ui32Port] == psCDCDevice)
+        {
+            break;
+        }
+    }
+    return(ui32Port);
+}
+
+// Offer the packet at the head of the OUT FIFO to the receive channel.
+static void CDCDataFromHost(tUSBDCDCDevice *psCDCDevice)
+{
+    uint32_t ui32Size;
+
+    ui32Size = USBDCDCRxPacketAvailable(psCDCDevice);
+    if(ui32Size)
+    {
+        psCDCDevice->pfnRxCallback(psCDCDevice->pvRxCBData,
+                                   USB_EVENT_RX_AVAILABLE, ui32Size, 0);
+    }
+}
+
+static void CDCFrame(tUSBDCDCDevice *psCDCDevice)
+{
+    if(psCDCDevice->sPrivateData.bConnected)
+    {
+        CDCDataFromHost(psCDCDevice);
+    }
+}
+
+static void CDCEndpointHandler(void *pvInstance, uint32_t ui32Status)
+{
+    tUSBDCDCDevice *psCDCDevice;
+    tCDCSerInstance *psInst;
+    uint32_t ui32Size;
+
+    psCDCDevice = pvInstance;
+    psInst = &psCDCDevice->sPrivateData;
+
+    if(ui32Status & EP_STATUS_IN(psInst->ui8BulkINEndpoint))
+    {
+        ui32Size = psInst->ui16LastTxSize;
+        psInst->ui16LastTxSize = 0;
+        psInst->bTxBusy = false;
+        psCDCDevice->pfnTxCallback(psCDCDevice->pvTxCBData,
+                                   USB_EVENT_TX_COMPLETE, ui32Size, 0);
+    }
+    if(ui32Status & EP_STATUS_OUT(psInst->ui8BulkOUTEndpoint))
+    {
+        CDCDataFromHost(psCDCDevice);
+    }
+}
+
+static void CDCConfigChange(void *pvInstance, uint32_t ui32Info)
+{
+    tUSBDCDCDevice *psCDCDevice;
+    tCDCSerInstance *psInst;
+
+    psCDCDevice = pvInstance;
+    psInst = &psCDCDevice->sPrivateData;
+    psInst->bConnected = true;
+    psInst->bTxBusy = false;
+    psInst->ui16LastTxSize = 0;
+    psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                    USB_EVENT_CONNECTED, 0, 0);
+}
+
+static void CDCSuspendHandler(void *pvInstance)
+{
+    tUSBDCDCDevice *psCDCDevice;
+
+    psCDCDevice = pvInstance;
+    psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                    USB_EVENT_SUSPEND, 0, 0);
+}
+
+static void CDCResumeHandler(void *pvInstance)
+{
+    tUSBDCDCDevice *psCDCDevice;
+
+    psCDCDevice = pvInstance;
+    psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                    USB_EVENT_RESUME, 0, 0);
+}
+
+// The class requests of the ACM subclass.  The data stage of an OUT request
+// is already in g_sEP0.
+static void CDCRequestHandler(void *pvInstance, tUSBRequest *psUSBRequest)
+{
+    tUSBDCDCDevice *psCDCDevice;
+    tCDCSerInstance *psInst;
+
+    psCDCDevice = pvInstance;
+    psInst = &psCDCDevice->sPrivateData;
+
+    if((psUSBRequest->bmRequestType & USB_RTYPE_TYPE_M) != USB_RTYPE_CLASS)
+    {
+        USBDCDStallEP0(0);
+        return;
+    }
+
+    switch(psUSBRequest->bRequest)
+    {
+        case USB_CDC_SET_LINE_CODING:
+        {
+            if(psUSBRequest->wLength < sizeof(tLineCoding))
+            {
+                USBDCDStallEP0(0);
+                break;
+            }
+            memcpy(&psInst->sLineCoding, g_sEP0.pui8Data,
+                   sizeof(tLineCoding));
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, true);
+            psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                            USBD_CDC_EVENT_SET_LINE_CODING,
+                                            0, &psInst->sLineCoding);
+            break;
+        }
+        case USB_CDC_GET_LINE_CODING:
+        {
+            psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                            USBD_CDC_EVENT_GET_LINE_CODING,
+                                            0, &psInst->sLineCoding);
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, false);
+            USBDCDSendDataEP0(0, (uint8_t *)&psInst->sLineCoding,
+                              sizeof(tLineCoding));
+            break;
+        }
+        case USB_CDC_SET_CONTROL_LINE_STATE:
+        {
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, true);
+            psCDCDevice->pfnControlCallback(
+                psCDCDevice->pvControlCBData,
+                USBD_CDC_EVENT_SET_CONTROL_LINE_STATE,
+                psUSBRequest->wValue, 0);
+            break;
+        }
+        case USB_CDC_SEND_BREAK:
+        {
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, true);
+            psCDCDevice->pfnControlCallback(psCDCDevice->pvControlCBData,
+                                            psUSBRequest->wValue ?
+                                            USBD_CDC_EVENT_SEND_BREAK :
+                                            USBD_CDC_EVENT_CLEAR_BREAK,
+                                            0, 0);
+            break;
+        }
+        default:
+        {
+            USBDCDStallEP0(0);
+            break;
+        }
+    }
+}
+
+static const tCustomHandlers g_sCDCHandlers =
+{
+    0,
+    CDCRequestHandler,
+    0,
+    CDCConfigChange,
+    0,
+    0,
+    0,
+    CDCSuspendHandler,
+    CDCResumeHandler,
+    0,
+    CDCEndpointHandler
+};
+
+// Set up a CDC instance as the next port: endpoints 1 + 2n for data and
+// 2 + 2n for notifications.
+static void CDCInstanceInit(tUSBDCDCDevice *psCDCDevice)
+{
+    tCDCSerInstance *psInst;
+    uint32_t ui32Port;
+
+    ui32Port = g_ui32NumPorts++;
+    g_ppsPorts[ui32Port] = psCDCDevice;
+
+    psInst = &psCDCDevice->sPrivateData;
+    memset(psInst, 0, sizeof(*psInst));
+    psInst->ui32USBBase = USB0_BASE;
+    psInst->sDevInfo.psCallbacks = &g_sCDCHandlers;
+    psInst->sDevInfo.ppui8StringDescriptors =
+        psCDCDevice->ppui8StringDescriptors;
+    psInst->sDevInfo.ui32NumStringDescriptors =
+        psCDCDevice->ui32NumStringDescriptors;
+    psInst->ui8BulkINEndpoint = USB_EP_1 + (ui32Port * 2 * USB_EP_1);
+    psInst->ui8BulkOUTEndpoint = psInst->ui8BulkINEndpoint;
+    psInst->ui8ControlEndpoint = psInst->ui8BulkINEndpoint + USB_EP_1;
+    psInst->sLineCoding.ui32Rate = 115200;
+    psInst->sLineCoding.ui8Databits = 8;
+
+    Endpoint(psInst->ui8BulkOUTEndpoint)->ui32OutDepth = 1;
+    Endpoint(psInst->ui8BulkINEndpoint)->ui32InDepth = 1;
+}
+
+void *USBDCDCInit(uint32_t ui32Index, tUSBDCDCDevice *psCDCDevice)
+{
+    CDCInstanceInit(psCDCDevice);
+    DeviceConnect(&psCDCDevice->sPrivateData.sDevInfo, psCDCDevice);
+    return(psCDCDevice);
+}
+
+void *USBDCDCCompositeInit(uint32_t ui32Index, tUSBDCDCDevice *psCDCDevice,
+                           tCompositeEntry *psCompEntry)
+{
+    CDCInstanceInit(psCDCDevice);
+    psCompEntry->psDevInfo = &psCDCDevice->sPrivateData.sDevInfo;
+    psCompEntry->pvInstance = psCDCDevice;
+    return(psCDCDevice);
+}
+
+uint32_t USBDCDCPacketWrite(void *pvCDCDevice, uint8_t *pui8Data,
+                            uint32_t ui32Length, bool bLast)
+{
+    tCDCSerInstance *psInst;
+    tSimEndpoint *psEP;
+    tSimPacket *psPacket;
+
+    psInst = &((tUSBDCDCDevice *)pvCDCDevice)->sPrivateData;
+    psEP = Endpoint(psInst->ui8BulkINEndpoint);
+    psPacket = &psEP->psIn[psEP->ui32InCount];
+    if(psInst->bTxBusy || ((psPacket->ui32Size + ui32Length) > MAX_PACKET_SIZE))
+    {
+        return(0);
+    }
+
+    memcpy(&psPacket->pui8Data[psPacket->ui32Size], pui8Data, ui32Length);
+    psPacket->ui32Size += ui32Length;
+    psInst->ui16LastTxSize += ui32Length;
+    if(bLast)
+    {
+        // The packet is sent, as far as the driver can tell, once the FIFO
+        // has room for the next.
+        psInst->bTxBusy = true;
+        psEP->ui32InCount++;
+        if(psEP->ui32InCount < psEP->ui32InDepth)
+        {
+            g_ui32EPStatus |= EP_STATUS_IN(psInst->ui8BulkINEndpoint);
+            HostSimIntTrigger(INT_USB0);
+        }
+        else
+        {
+            psEP->bInWaiting = true;
+        }
+    }
+    return(ui32Length);
+}
+
+uint32_t USBDCDCPacketRead(void *pvCDCDevice, uint8_t *pui8Data,
+                           uint32_t ui32Length, bool bLast)
+{
+    tCDCSerInstance *psInst;
+    tSimEndpoint *psEP;
+    tSimPacket *psPacket;
+    uint32_t ui32Count;
+
+    psInst = &((tUSBDCDCDevice *)pvCDCDevice)->sPrivateData;
+    psEP = Endpoint(psInst->ui8BulkOUTEndpoint);
+    if(!psEP->ui32OutCount)
+    {
+        return(0);
+    }
+
+    psPacket = &psEP->psOut[0];
+    ui32Count = psPacket->ui32Size - psEP->ui32OutRead;
+    if(ui32Count > ui32Length)
+    {
+        ui32Count = ui32Length;
+    }
+    memcpy(pui8Data, &psPacket->pui8Data[psEP->ui32OutRead], ui32Count);
+    psEP->ui32OutRead += ui32Count;
+
+    // Acknowledge the packet once it has been read in full, which lets the
+    // next one in.
+    if(psEP->ui32OutRead == psPacket->ui32Size)
+    {
+        psEP->psOut[0] = psEP->psOut[1];
+        psEP->ui32OutCount--;
+        psEP->ui32OutRead = 0;
+    }
+    return(ui32Count);
+}
+
+uint32_t USBDCDCTxPacketAvailable(void *pvCDCDevice)
+{
+    tCDCSerInstance *psInst;
+
+    psInst = &((tUSBDCDCDevice *)pvCDCDevice)->sPrivateData;
+    return((psInst->bConnected && !psInst->bTxBusy) ? MAX_PACKET_SIZE : 0);
+}
+
+uint32_t USBDCDCRxPacketAvailable(void *pvCDCDevice)
+{
+    tCDCSerInstance *psInst;
+    tSimEndpoint *psEP;
+
+    psInst = &((tUSBDCDCDevice *)pvCDCDevice)->sPrivateData;
+    psEP = Endpoint(psInst->ui8BulkOUTEndpoint);
+    if(!psEP->ui32OutCount)
+    {
+        return(0);
+    }
+    return(psEP->psOut[0].ui32Size - psEP->ui32OutRead);
+}
+
+void USBDCDCSerialStateChange(void *pvCDCDevice, uint16_t ui16State)
+{
+    tUSBDCDCDevice *psCDCDevice;
+
+    psCDCDevice = pvCDCDevice;
+    psCDCDevice->sPrivateData.ui16SerialState = ui16State;
+    g_pui32Notifications[PortFromInstance(psCDCDevice)]++;
+}
+
+//*****************************************************************************
+//
+// The composite device driver.  Events go to every function and class
+// requests to the function owning the interface, two per CDC function.
+//
+//*****************************************************************************
+static tUSBDCompositeDevice *g_psCompDevice;
+
+static void CompositeRequestHandler(void *pvInstance,
+                                    tUSBRequest *psUSBRequest)
+{
+    tCompositeEntry *psEntry;
+    uint32_t ui32Function;
+
+    ui32Function = (psUSBRequest->wIndex & 0xff) / 2;
+    if(((psUSBRequest->bmRequestType & USB_RTYPE_RECIPIENT_M) !=
+        USB_RTYPE_INTERFACE) ||
+       (ui32Function >= g_psCompDevice->ui32NumDevices))
+    {
+        USBDCDStallEP0(0);
+        return;
+    }
+
+    psEntry = &g_psCompDevice->psDevices[ui32Function];
+    psEntry->psDevInfo->psCallbacks->pfnRequestHandler(psEntry->pvInstance,
+                                                       psUSBRequest);
+}
+
+static void CompositeConfigChange(void *pvInstance, uint32_t ui32Info)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_psCompDevice->ui32NumDevices; ui32Idx++)
+    {
+        CDCConfigChange(g_psCompDevice->psDevices[ui32Idx].pvInstance,
+                        ui32Info);
+    }
+}
+
+static void CompositeSuspendHandler(void *pvInstance)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_psCompDevice->ui32NumDevices; ui32Idx++)
+    {
+        CDCSuspendHandler(g_psCompDevice->psDevices[ui32Idx].pvInstance);
+    }
+}
+
+static void CompositeResumeHandler(void *pvInstance)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_psCompDevice->ui32NumDevices; ui32Idx++)
+    {
+        CDCResumeHandler(g_psCompDevice->psDevices[ui32Idx].pvInstance);
+    }
+}
+
+static void CompositeEndpointHandler(void *pvInstance, uint32_t ui32Status)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < g_psCompDevice->ui32NumDevices; ui32Idx++)
+    {
+        CDCEndpointHandler(g_psCompDevice->psDevices[ui32Idx].pvInstance,
+                           ui32Status);
+    }
+}
+
+static const tCustomHandlers g_sCompositeHandlers =
+{
+    0,
+    CompositeRequestHandler,
+    0,
+    CompositeConfigChange,
+    0,
+    0,
+    0,
+    CompositeSuspendHandler,
+    CompositeResumeHandler,
+    0,
+    CompositeEndpointHandler
+};
+
+void *USBDCompositeInit(uint32_t ui32Index, tUSBDCompositeDevice *psCompDevice,
+                        uint32_t ui32Size, uint8_t *pui8Data)
+{
+    tCompositeInstance *psInst;
+
+    g_psCompDevice = psCompDevice;
+    psInst = &psCompDevice->sPrivateData;
+    psInst->ui32USBBase = USB0_BASE;
+    psInst->sDevInfo.psCallbacks = &g_sCompositeHandlers;
+    psInst->sDevInfo.ppui8StringDescriptors =
+        psCompDevice->ppui8StringDescriptors;
+    psInst->sDevInfo.ui32NumStringDescriptors =
+        psCompDevice->ui32NumStringDescriptors;
+    psInst->pui8Data = pui8Data;
+    psInst->ui32DataSize = ui32Size;
+    DeviceConnect(&psInst->sDevInfo, psCompDevice);
+    return(psCompDevice);
+}
+
+//*****************************************************************************
+//
+// Ring buffers.
+//
+//*****************************************************************************
+uint32_t USBRingBufUsed(tUSBRingBufObject *psUSBRingBuf)
+{
+    uint32_t ui32Write, ui32Read;
+
+    ui32Write = psUSBRingBuf->ui32WriteIndex;
+    ui32Read = psUSBRingBuf->ui32ReadIndex;
+    return((ui32Write >= ui32Read) ? (ui32Write - ui32Read) :
+           (psUSBRingBuf->ui32Size - ui32Read + ui32Write));
+}
+
+uint32_t USBRingBufFree(tUSBRingBufObject *psUSBRingBuf)
+{
+    return((psUSBRingBuf->ui32Size - USBRingBufUsed(psUSBRingBuf)) - 1);
+}
+
+uint32_t USBRingBufContigUsed(tUSBRingBufObject *psUSBRingBuf)
+{
+    uint32_t ui32Write, ui32Read;
+
+    ui32Write = psUSBRingBuf->ui32WriteIndex;
+    ui32Read = psUSBRingBuf->ui32ReadIndex;
+    return((ui32Write >= ui32Read) ? (ui32Write - ui32Read) :
+           (psUSBRingBuf->ui32Size - ui32Read));
+}
+
+uint32_t USBRingBufContigFree(tUSBRingBufObject *psUSBRingBuf)
+{
+    uint32_t ui32Write, ui32Read;
+
+    ui32Write = psUSBRingBuf->ui32WriteIndex;
+    ui32Read = psUSBRingBuf->ui32ReadIndex;
+    if(ui32Read > ui32Write)
+    {
+        return((ui32Read - ui32Write) - 1);
+    }
+    return((psUSBRingBuf->ui32Size - ui32Write) - ((ui32Read == 0) ? 1 : 0));
+}
+
+static void RingAdvance(tUSBRingBufObject *psUSBRingBuf,
+                        volatile uint32_t *pui32Index, uint32_t ui32Count)
+{
+    *pui32Index = (*pui32Index + ui32Count) % psUSBRingBuf->ui32Size;
+}
+
+//*****************************************************************************
+//
+// USB buffers.
+//
+//*****************************************************************************
+typedef struct
+{
+    tUSBRingBufObject sRingBuf;
+    uint32_t ui32LastSent;
+    bool bSendZLP;
+} tUSBBufferVars;
+
+_Static_assert(sizeof(tUSBBufferVars) <= USB_BUFFER_WORKSPACE_SIZE,
+               "USB_BUFFER_WORKSPACE_SIZE too small");
+
+static tUSBBufferVars *BufferVars(const tUSBBuffer *psBuffer)
+{
+    return(psBuffer->pvWorkspace);
+}
+
+// Hand the next packet of a transmit buffer to the class driver if it can
+// take one.
+static void ScheduleNextTransmission(const tUSBBuffer *psBuffer)
+{
+    tUSBBufferVars *psVars;
+    tUSBRingBufObject *psRing;
+    uint32_t ui32Packet, ui32Avail, ui32ToEnd, ui32Sent;
+
+    psVars = BufferVars(psBuffer);
+    psRing = &psVars->sRingBuf;
+
+    ui32Packet = psBuffer->pfnAvailable(psBuffer->pvHandle);
+    if(!ui32Packet)
+    {
+        return;
+    }
+
+    ui32Avail = USBRingBufUsed(psRing);
+    if(ui32Avail)
+    {
+        if(ui32Packet > ui32Avail)
+        {
+            ui32Packet = ui32Avail;
+        }
+        ui32ToEnd = USBRingBufContigUsed(psRing);
+        if(ui32Packet > ui32ToEnd)
+        {
+            ui32Sent = psBuffer->pfnTransfer(psBuffer->pvHandle,
+                                             &psRing->pui8Buf[
+                                                 psRing->ui32ReadIndex],
+                                             ui32ToEnd, false);
+            if(ui32Sent == ui32ToEnd)
+            {
+                ui32Sent += psBuffer->pfnTransfer(psBuffer->pvHandle,
+                                                  psRing->pui8Buf,
+                                                  ui32Packet - ui32ToEnd,
+                                                  true);
+            }
+        }
+        else
+        {
+            ui32Sent = psBuffer->pfnTransfer(psBuffer->pvHandle,
+                                             &psRing->pui8Buf[
+                                                 psRing->ui32ReadIndex],
+                                             ui32Packet, true);
+        }
+        psVars->ui32LastSent = ui32Sent;
+    }
+    else if(psVars->bSendZLP && (psVars->ui32LastSent == MAX_PACKET_SIZE))
+    {
+        psBuffer->pfnTransfer(psBuffer->pvHandle, psRing->pui8Buf, 0, true);
+        psVars->ui32LastSent = 0;
+    }
+}
+
+static uint32_t HandleRxAvailable(const tUSBBuffer *psBuffer,
+                                  uint32_t ui32Size)
+{
+    tUSBBufferVars *psVars;
+    tUSBRingBufObject *psRing;
+    uint32_t ui32Read, ui32Count, ui32Total;
+
+    psVars = BufferVars(psBuffer);
+    psRing = &psVars->sRingBuf;
+
+    // Read as much of the packet as fits, in two parts if it wraps.
+    ui32Total = 0;
+    while(ui32Total < ui32Size)
+    {
+        ui32Read = USBRingBufContigFree(psRing);
+        if(ui32Read > (ui32Size - ui32Total))
+        {
+            ui32Read = ui32Size - ui32Total;
+        }
+        if(!ui32Read)
+        {
+            break;
+        }
+        ui32Count = psBuffer->pfnTransfer(psBuffer->pvHandle,
+                                          &psRing->pui8Buf[
+                                              psRing->ui32WriteIndex],
+                                          ui32Read, true);
+        RingAdvance(psRing, &psRing->ui32WriteIndex, ui32Count);
+        ui32Total += ui32Count;
+        if(ui32Count < ui32Read)
+        {
+            break;
+        }
+    }
+
+    psBuffer->pfnCallback(psBuffer->pvCBData, USB_EVENT_RX_AVAILABLE,
+                          USBRingBufUsed(psRing), 0);
+    return(ui32Total);
+}
+
+static uint32_t HandleTxComplete(const tUSBBuffer *psBuffer, uint32_t ui32Size)
+{
+    tUSBBufferVars *psVars;
+
+    psVars = BufferVars(psBuffer);
+    RingAdvance(&psVars->sRingBuf, &psVars->sRingBuf.ui32ReadIndex, ui32Size);
+    ScheduleNextTransmission(psBuffer);
+    psBuffer->pfnCallback(psBuffer->pvCBData, USB_EVENT_TX_COMPLETE, ui32Size,
+                          0);
+    return(0);
+}
+
+const tUSBBuffer *USBBufferInit(const tUSBBuffer *psBuffer)
+{
+    tUSBBufferVars *psVars;
+
+    psVars = BufferVars(psBuffer);
+    memset(psVars, 0, sizeof(*psVars));
+    psVars->sRingBuf.ui32Size = psBuffer->ui32BufferSize;
+    psVars->sRingBuf.pui8Buf = psBuffer->pui8Buffer;
+    return(psBuffer);
+}
+
+void USBBufferInfoGet(const tUSBBuffer *psBuffer,
+                      tUSBRingBufObject *psRingBuf)
+{
+    *psRingBuf = BufferVars(psBuffer)->sRingBuf;
+}
+
+// usblib moves the data of USBBufferRead() and USBBufferWrite() a byte at a
+// time through USBRingBufReadOne() and USBRingBufWriteOne(), and so does
+// this.
+uint32_t USBBufferRead(const tUSBBuffer *psBuffer, uint8_t *pui8Data,
+                       uint32_t ui32Length)
+{
+    tUSBRingBufObject *psRing;
+    uint32_t ui32Count, ui32Idx;
+
+    psRing = &BufferVars(psBuffer)->sRingBuf;
+    ui32Count = USBRingBufUsed(psRing);
+    if(ui32Count > ui32Length)
+    {
+        ui32Count = ui32Length;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++)
+    {
+        pui8Data[ui32Idx] = psRing->pui8Buf[psRing->ui32ReadIndex];
+        RingAdvance(psRing, &psRing->ui32ReadIndex, 1);
+    }
+    return(ui32Count);
+}
+
+uint32_t USBBufferWrite(const tUSBBuffer *psBuffer, const uint8_t *pui8Data,
+                        uint32_t ui32Length)
+{
+    tUSBRingBufObject *psRing;
+    uint32_t ui32Count, ui32Idx;
+
+    psRing = &BufferVars(psBuffer)->sRingBuf;
+    ui32Count = USBRingBufFree(psRing);
+    if(ui32Count > ui32Length)
+    {
+        ui32Count = ui32Length;
+    }
+    for(ui32Idx = 0; ui32Idx < ui32Count; ui32Idx++)
+    {
+        psRing->pui8Buf[psRing->ui32WriteIndex] = pui8Data[ui32Idx];
+        RingAdvance(psRing, &psRing->ui32WriteIndex, 1);
+    }
+    if(psBuffer->bTransmitBuffer)
+    {
+        ScheduleNextTransmission(psBuffer);
+    }
+    return(ui32Count);
+}
+
+void USBBufferDataWritten(const tUSBBuffer *psBuffer, uint32_t ui32Length)
+{
+    tUSBRingBufObject *psRing;
+
+    psRing = &BufferVars(psBuffer)->sRingBuf;
+    RingAdvance(psRing, &psRing->ui32WriteIndex, ui32Length);
+    if(psBuffer->bTransmitBuffer)
+    {
+        ScheduleNextTransmission(psBuffer);
+    }
+}
+
+void USBBufferDataRemoved(const tUSBBuffer *psBuffer, uint32_t ui32Length)
+{
+    tUSBRingBufObject *psRing;
+
+    psRing = &BufferVars(psBuffer)->sRingBuf;
+    RingAdvance(psRing, &psRing->ui32ReadIndex, ui32Length);
+}
+
+void USBBufferFlush(const tUSBBuffer *psBuffer)
+{
+    tUSBRingBufObject *psRing;
+
+    psRing = &BufferVars(psBuffer)->sRingBuf;
+    psRing->ui32ReadIndex = psRing->ui32WriteIndex;
+}
+
+uint32_t USBBufferDataAvailable(const tUSBBuffer *psBuffer)
+{
+    return(USBRingBufUsed(&BufferVars(psBuffer)->sRingBuf));
+}
+
+uint32_t USBBufferSpaceAvailable(const tUSBBuffer *psBuffer)
+{
+    return(USBRingBufFree(&BufferVars(psBuffer)->sRingBuf));
+}
+
+bool USBBufferZeroLengthPacketInsert(const tUSBBuffer *psBuffer,
+                                     bool bSendZLP)
+{
+    BufferVars(psBuffer)->bSendZLP = bSendZLP;
+    return(true);
+}
+
+uint32_t USBBufferEventCallback(void *pvCBData, uint32_t ui32Event,
+                                uint32_t ui32MsgValue, void *pvMsgData)
+{
+    const tUSBBuffer *psBuffer;
+
+    psBuffer = pvCBData;
+    switch(ui32Event)
+    {
+        case USB_EVENT_RX_AVAILABLE:
+        {
+            return(psBuffer->bTransmitBuffer ? 0 :
+                   HandleRxAvailable(psBuffer, ui32MsgValue));
+        }
+        case USB_EVENT_TX_COMPLETE:
+        {
+            return(psBuffer->bTransmitBuffer ?
+                   HandleTxComplete(psBuffer, ui32MsgValue) : 0);
+        }
+        case USB_EVENT_DATA_REMAINING:
+        {
+            return(USBRingBufUsed(&BufferVars(psBuffer)->sRingBuf) +
+                   psBuffer->pfnCallback(psBuffer->pvCBData, ui32Event,
+                                         ui32MsgValue, pvMsgData));
+        }
+        case USB_EVENT_REQUEST_BUFFER:
+        {
+            return(0);
+        }
+        default:
+        {
+            return(psBuffer->pfnCallback(psBuffer->pvCBData, ui32Event,
+                                         ui32MsgValue, pvMsgData));
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * usbdcdc.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/device/usbdcdc.h.  The instance data
+// only keeps what the simulated class driver in usblib.c needs.
+
+#ifndef __USBDCDC_H__
+#define __USBDCDC_H__
+
+#define USBD_CDC_EVENT_BASE     0x6000
+#define USBD_CDC_EVENT_SEND_BREAK   (USBD_CDC_EVENT_BASE + 0)
+#define USBD_CDC_EVENT_CLEAR_BREAK  (USBD_CDC_EVENT_BASE + 1)
+#define USBD_CDC_EVENT_SET_CONTROL_LINE_STATE   (USBD_CDC_EVENT_BASE + 2)
+#define USBD_CDC_EVENT_SET_LINE_CODING  (USBD_CDC_EVENT_BASE + 3)
+#define USBD_CDC_EVENT_GET_LINE_CODING  (USBD_CDC_EVENT_BASE + 4)
+
+// Bytes of configuration descriptor one CDC function adds to a composite
+// device.
+#define COMPOSITE_DCDC_SIZE     (8 + 9 + 5 + 5 + 4 + 5 + 7 + 9 + 7 + 7)
+
+typedef struct
+{
+    uint32_t ui32USBBase;
+    tDeviceInfo sDevInfo;
+    volatile bool bConnected;
+    volatile uint16_t ui16SerialState;
+    tLineCoding sLineCoding;
+    uint8_t ui8ControlEndpoint;
+    uint8_t ui8BulkINEndpoint;
+    uint8_t ui8BulkOUTEndpoint;
+    volatile bool bTxBusy;
+    uint16_t ui16LastTxSize;
+} tCDCSerInstance;
+
+typedef struct
+{
+    const uint16_t ui16VID;
+    const uint16_t ui16PID;
+    const uint16_t ui16MaxPowermA;
+    const uint8_t ui8PwrAttributes;
+    const tUSBCallback pfnControlCallback;
+    void * const pvControlCBData;
+    const tUSBCallback pfnRxCallback;
+    void * const pvRxCBData;
+    const tUSBCallback pfnTxCallback;
+    void * const pvTxCBData;
+    const uint8_t * const *ppui8StringDescriptors;
+    const uint32_t ui32NumStringDescriptors;
+    tCDCSerInstance sPrivateData;
+} tUSBDCDCDevice;
+
+struct tCompositeEntryTag;
+
+extern void *USBDCDCInit(uint32_t ui32Index, tUSBDCDCDevice *psCDCDevice);
+extern void *USBDCDCCompositeInit(uint32_t ui32Index,
+                                  tUSBDCDCDevice *psCDCDevice,
+                                  struct tCompositeEntryTag *psCompEntry);
+extern uint32_t USBDCDCPacketWrite(void *pvCDCDevice, uint8_t *pui8Data,
+                                   uint32_t ui32Length, bool bLast);
+extern uint32_t USBDCDCPacketRead(void *pvCDCDevice, uint8_t *pui8Data,
+                                  uint32_t ui32Length, bool bLast);
+extern uint32_t USBDCDCTxPacketAvailable(void *pvCDCDevice);
+extern uint32_t USBDCDCRxPacketAvailable(void *pvCDCDevice);
+extern void USBDCDCSerialStateChange(void *pvCDCDevice, uint16_t ui16State);
+
+#endif // __USBDCDC_H__
@@ -0,0 +1,45 @@
+/*
+ * usbdcomp.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/device/usbdcomp.h.
+
+#ifndef __USBDCOMP_H__
+#define __USBDCOMP_H__
+
+typedef struct tCompositeEntryTag
+{
+    const tDeviceInfo *psDevInfo;
+    void *pvInstance;
+} tCompositeEntry;
+
+typedef struct
+{
+    uint32_t ui32USBBase;
+    tDeviceInfo sDevInfo;
+    uint8_t *pui8Data;
+    uint32_t ui32DataSize;
+} tCompositeInstance;
+
+typedef struct
+{
+    const uint16_t ui16VID;
+    const uint16_t ui16PID;
+    const uint16_t ui16MaxPowermA;
+    const uint8_t ui8PwrAttributes;
+    const tUSBCallback pfnCallback;
+    const uint8_t * const *ppui8StringDescriptors;
+    const uint32_t ui32NumStringDescriptors;
+    const uint32_t ui32NumDevices;
+    tCompositeEntry * const psDevices;
+    tCompositeInstance sPrivateData;
+} tUSBDCompositeDevice;
+
+extern void *USBDCompositeInit(uint32_t ui32Index,
+                               tUSBDCompositeDevice *psCompDevice,
+                               uint32_t ui32Size, uint8_t *pui8Data);
+
+#endif // __USBDCOMP_H__
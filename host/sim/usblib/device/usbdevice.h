@@ -0,0 +1,18 @@
+/*
+ * usbdevice.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/device/usbdevice.h: the endpoint 0 calls
+// a request handler uses to answer.
+
+#ifndef __USBDEVICE_H__
+#define __USBDEVICE_H__
+
+extern void USBDCDSendDataEP0(uint32_t ui32Index, uint8_t *pui8Data,
+                              uint32_t ui32Size);
+extern void USBDCDStallEP0(uint32_t ui32Index);
+
+#endif // __USBDEVICE_H__
@@ -0,0 +1,17 @@
+/*
+ * usb-ids.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/usb-ids.h.
+
+#ifndef __USBIDS_H__
+#define __USBIDS_H__
+
+#define USB_VID_TI_1CBE         0x1CBE
+#define USB_PID_SERIAL          0x0002
+#define USB_PID_COMP_SERIAL     0x0007
+
+#endif // __USBIDS_H__
@@ -0,0 +1,45 @@
+/*
+ * usbcdc.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/usbcdc.h.
+
+#ifndef __USBCDC_H__
+#define __USBCDC_H__
+
+#define USB_CDC_STOP_BITS_1     0x00
+#define USB_CDC_STOP_BITS_1_5   0x01
+#define USB_CDC_STOP_BITS_2     0x02
+
+#define USB_CDC_PARITY_NONE     0x00
+#define USB_CDC_PARITY_ODD      0x01
+#define USB_CDC_PARITY_EVEN     0x02
+#define USB_CDC_PARITY_MARK     0x03
+#define USB_CDC_PARITY_SPACE    0x04
+
+#define USB_CDC_DTE_PRESENT     0x01
+#define USB_CDC_ACTIVATE_CARRIER    0x02
+
+#define USB_CDC_SERIAL_STATE_OVERRUN    0x0040
+#define USB_CDC_SERIAL_STATE_PARITY     0x0020
+#define USB_CDC_SERIAL_STATE_FRAMING    0x0010
+#define USB_CDC_SERIAL_STATE_BREAK      0x0004
+
+// Class requests of the ACM subclass.
+#define USB_CDC_SET_LINE_CODING         0x20
+#define USB_CDC_GET_LINE_CODING         0x21
+#define USB_CDC_SET_CONTROL_LINE_STATE  0x22
+#define USB_CDC_SEND_BREAK              0x23
+
+typedef struct __attribute__((packed))
+{
+    uint32_t ui32Rate;
+    uint8_t ui8Stop;
+    uint8_t ui8Parity;
+    uint8_t ui8Databits;
+} tLineCoding;
+
+#endif // __USBCDC_H__
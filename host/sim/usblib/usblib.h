@@ -0,0 +1,155 @@
+/*
+ * usblib.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare usblib/usblib.h: the USB buffer and ring buffer
+// API, the standard request definitions and the device information the class
+// drivers hand to the device core.  The implementation is in usblib.c.
+
+#ifndef __USBLIB_H__
+#define __USBLIB_H__
+
+// Build a little-endian 16-bit value into a descriptor.
+#define USBShort(ui16Value)     ((ui16Value) & 0xff), ((ui16Value) >> 8)
+
+#define USB_DTYPE_STRING        3
+#define USB_LANG_EN_US          0x0409
+#define USB_CONF_ATTR_SELF_PWR  0xC0
+
+// Fields of bmRequestType.
+#define USB_RTYPE_DIR_IN        0x80
+#define USB_RTYPE_DIR_OUT       0x00
+#define USB_RTYPE_TYPE_M        0x60
+#define USB_RTYPE_VENDOR        0x40
+#define USB_RTYPE_CLASS         0x20
+#define USB_RTYPE_STANDARD      0x00
+#define USB_RTYPE_RECIPIENT_M   0x1f
+#define USB_RTYPE_INTERFACE     0x01
+#define USB_RTYPE_DEVICE        0x00
+
+// Events passed to the class driver and buffer callbacks.
+#define USB_EVENT_BASE          0x0000
+#define USB_EVENT_CONNECTED     (USB_EVENT_BASE + 0)
+#define USB_EVENT_DISCONNECTED  (USB_EVENT_BASE + 1)
+#define USB_EVENT_RX_AVAILABLE  (USB_EVENT_BASE + 2)
+#define USB_EVENT_DATA_REMAINING    (USB_EVENT_BASE + 3)
+#define USB_EVENT_REQUEST_BUFFER    (USB_EVENT_BASE + 4)
+#define USB_EVENT_TX_COMPLETE   (USB_EVENT_BASE + 5)
+#define USB_EVENT_ERROR         (USB_EVENT_BASE + 6)
+#define USB_EVENT_SUSPEND       (USB_EVENT_BASE + 7)
+#define USB_EVENT_RESUME        (USB_EVENT_BASE + 8)
+
+// The setup packet of a control request.
+typedef struct __attribute__((packed))
+{
+    uint8_t bmRequestType;
+    uint8_t bRequest;
+    uint16_t wValue;
+    uint16_t wIndex;
+    uint16_t wLength;
+} tUSBRequest;
+
+typedef uint32_t (*tUSBCallback)(void *pvCBData, uint32_t ui32Event,
+                                 uint32_t ui32MsgParam, void *pvMsgData);
+typedef uint32_t (*tUSBPacketTransfer)(void *pvHandle, uint8_t *pui8Data,
+                                       uint32_t ui32Length, bool bLast);
+typedef uint32_t (*tUSBPacketAvailable)(void *pvHandle);
+
+// The handlers a class driver gives the device core.
+typedef void (*tStdRequest)(void *pvInstance, tUSBRequest *psUSBRequest);
+typedef void (*tInfoCallback)(void *pvInstance, uint32_t ui32Info);
+typedef void (*tUSBIntHandler)(void *pvInstance);
+typedef void (*tUSBEPIntHandler)(void *pvInstance, uint32_t ui32Status);
+
+typedef struct
+{
+    tStdRequest pfnGetDescriptor;
+    tStdRequest pfnRequestHandler;
+    tInfoCallback pfnInterfaceChange;
+    tInfoCallback pfnConfigChange;
+    tInfoCallback pfnDataReceived;
+    tInfoCallback pfnDataSent;
+    tUSBIntHandler pfnResetHandler;
+    tUSBIntHandler pfnSuspendHandler;
+    tUSBIntHandler pfnResumeHandler;
+    tUSBIntHandler pfnDisconnectHandler;
+    tUSBEPIntHandler pfnEndpointHandler;
+} tCustomHandlers;
+
+typedef struct
+{
+    const tCustomHandlers *psCallbacks;
+    const uint8_t * const *ppui8StringDescriptors;
+    uint32_t ui32NumStringDescriptors;
+} tDeviceInfo;
+
+typedef enum
+{
+    eUSBModeHost,
+    eUSBModeDevice,
+    eUSBModeOTG,
+    eUSBModeNone,
+    eUSBModeForceHost,
+    eUSBModeForceDevice
+} tUSBMode;
+
+typedef void (*tUSBModeCallback)(uint32_t ui32Index, tUSBMode iMode);
+
+extern void USBStackModeSet(uint32_t ui32Index, tUSBMode iUSBMode,
+                            tUSBModeCallback pfnCallback);
+
+// A ring buffer.  One byte is always left free so that a full ring can be
+// told from an empty one.
+typedef struct
+{
+    uint32_t ui32Size;
+    volatile uint32_t ui32WriteIndex;
+    volatile uint32_t ui32ReadIndex;
+    uint8_t *pui8Buf;
+} tUSBRingBufObject;
+
+extern uint32_t USBRingBufUsed(tUSBRingBufObject *psUSBRingBuf);
+extern uint32_t USBRingBufFree(tUSBRingBufObject *psUSBRingBuf);
+extern uint32_t USBRingBufContigUsed(tUSBRingBufObject *psUSBRingBuf);
+extern uint32_t USBRingBufContigFree(tUSBRingBufObject *psUSBRingBuf);
+
+// A buffer between a class driver's data channel and the application.
+typedef struct
+{
+    bool bTransmitBuffer;
+    tUSBCallback pfnCallback;
+    void *pvCBData;
+    tUSBPacketTransfer pfnTransfer;
+    tUSBPacketAvailable pfnAvailable;
+    void *pvHandle;
+    uint8_t *pui8Buffer;
+    uint32_t ui32BufferSize;
+    void *pvWorkspace;
+} tUSBBuffer;
+
+#define USB_BUFFER_WORKSPACE_SIZE   48
+
+extern const tUSBBuffer *USBBufferInit(const tUSBBuffer *psBuffer);
+extern void USBBufferInfoGet(const tUSBBuffer *psBuffer,
+                             tUSBRingBufObject *psRingBuf);
+extern uint32_t USBBufferRead(const tUSBBuffer *psBuffer, uint8_t *pui8Data,
+                              uint32_t ui32Length);
+extern uint32_t USBBufferWrite(const tUSBBuffer *psBuffer,
+                               const uint8_t *pui8Data, uint32_t ui32Length);
+extern void USBBufferDataWritten(const tUSBBuffer *psBuffer,
+                                 uint32_t ui32Length);
+extern void USBBufferDataRemoved(const tUSBBuffer *psBuffer,
+                                 uint32_t ui32Length);
+extern void USBBufferFlush(const tUSBBuffer *psBuffer);
+extern uint32_t USBBufferDataAvailable(const tUSBBuffer *psBuffer);
+extern uint32_t USBBufferSpaceAvailable(const tUSBBuffer *psBuffer);
+extern bool USBBufferZeroLengthPacketInsert(const tUSBBuffer *psBuffer,
+                                            bool bSendZLP);
+extern uint32_t USBBufferEventCallback(void *pvCBData, uint32_t ui32Event,
+                                       uint32_t ui32MsgValue,
+                                       void *pvMsgData);
+
+#endif // __USBLIB_H__
@@ -0,0 +1,18 @@
+/*
+ * uartstdio.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare utils/uartstdio.h.  The console goes to the
+// simulator's log stream, see HostSimConsole().
+
+#ifndef __UARTSTDIO_H__
+#define __UARTSTDIO_H__
+
+extern void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud,
+                            uint32_t ui32SrcClock);
+extern void UARTprintf(const char *pcString, ...);
+
+#endif // __UARTSTDIO_H__
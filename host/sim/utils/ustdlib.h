@@ -0,0 +1,13 @@
+/*
+ * ustdlib.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+// Host stand-in for TivaWare utils/ustdlib.h.  Nothing in it is used.
+
+#ifndef __USTDLIB_H__
+#define __USTDLIB_H__
+
+#endif // __USTDLIB_H__
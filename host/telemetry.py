@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#
+# telemetry.py - Poll the driver counters over the vendor control request.
+#
+# The snapshot is read with a control transfer to the device, which does not
+# claim the CDC interfaces, so this can run while the serial port is in use.
+# Requires pyusb.
+#
+
+import argparse
+import struct
+import sys
+import time
+
+import usb.core
+
+VID = 0x1CBE
+PID = 0x0002
+
+REQ_SNAPSHOT = 0x01
+REQ_LATENCY = 0x02
+REQ_TYPE_VENDOR_IN = 0xC0
+REQ_TYPE_VENDOR_OUT = 0x40
+
+# Must match USB_TELEMETRY_VERSION and tUSBTelemetry in usbtelemetry.h.
+VERSION = 9
+FLAG_PROFILE = 0x00000001
+
+HEADER = struct.Struct("<HHIII")
+# Groups repeated once per port, each group for all ports before the next.
+PORT_FIELDS = (
+    ("buffer", ("rx_blocks", "tx_blocks", "rx_peak", "tx_peak", "rx_full",
+                "tx_full", "rebalances", "rx_packets", "rx_bursts",
+                "rx_bytes")),
+    ("uart", ("tx_bytes", "rx_bytes", "rx_overruns", "rx_framing_errors",
+              "rx_parity_errors", "rx_breaks", "rx_dropped", "rx_throttles",
+              "tx_stalls")),
+    ("compress", ("raw_bytes", "coded_bytes", "blocks", "stored_blocks",
+                  "time_us")),
+)
+FIELDS = (
+    ("event", ("overflows",)),
+    ("power", ("suspends", "resumes", "sleeps", "resume_latency_us",
+               "resume_latency_max_us")),
+    ("stack", ("size", "peak", "nesting_max")),
+    ("latency", ("tick_cycles", "usb_cycles", "uart_cycles")),
+)
+
+# Must match usbprofile.h.
+# USBForward is recorded per 64 bytes copied rather than per call.
+PROBES = ("RxHandler", "TxHandler", "ControlHandler", "RxDataHandler",
+          "USBForward/64B")
+PROFILE_BUCKETS = 32
+PROFILE_BUCKET_SHIFT = 6
+
+
+def percentile(count, maximum, buckets, percent):
+    target = (count * percent + 99) // 100
+    seen = 0
+    for index, value in enumerate(buckets[:-1]):
+        seen += value
+        if seen >= target:
+            return min(((index + 1) << PROFILE_BUCKET_SHIFT) - 1, maximum)
+    return maximum
+
+
+def decode(data):
+    version, size, flags, sequence, ports = HEADER.unpack_from(data)
+    if version != VERSION:
+        raise ValueError("unsupported snapshot version %d" % version)
+
+    snapshot = {"sequence": sequence, "counters": {}}
+    offset = HEADER.size
+    for group, names in PORT_FIELDS:
+        for port in range(ports):
+            values = struct.unpack_from("<%dI" % len(names), data, offset)
+            offset += 4 * len(names)
+            snapshot["counters"]["%s%d" % (group, port)] = dict(
+                zip(names, values))
+
+    # Receive interrupts per MB received, to judge the burst budget.
+    for port in range(ports):
+        counters = snapshot["counters"]["buffer%d" % port]
+        if counters["rx_bytes"]:
+            counters["rx_irqs_per_mb"] = (counters["rx_bursts"] * 1048576 //
+                                          counters["rx_bytes"])
+    for group, names in FIELDS:
+        values = struct.unpack_from("<%dI" % len(names), data, offset)
+        offset += 4 * len(names)
+        snapshot["counters"][group] = dict(zip(names, values))
+
+    if flags & FLAG_PROFILE:
+        snapshot["profile"] = {}
+        for probe in PROBES:
+            count, minimum, maximum = struct.unpack_from("<3I", data, offset)
+            buckets = struct.unpack_from("<%dI" % PROFILE_BUCKETS, data,
+                                         offset + 12)
+            offset += 12 + 4 * PROFILE_BUCKETS
+            snapshot["profile"][probe] = {
+                "count": count,
+                "min": minimum if count else 0,
+                "max": maximum,
+                "p50": percentile(count, maximum, buckets, 50),
+                "p99": percentile(count, maximum, buckets, 99),
+                "buckets": buckets,
+            }
+    return snapshot
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Poll the CDC driver counters over endpoint 0.")
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="seconds between snapshots (default 1)")
+    parser.add_argument("--count", type=int, default=0,
+                        help="number of snapshots, 0 for no limit")
+    parser.add_argument("--latency", type=int,
+                        help="set the latency timer in ms and exit")
+    args = parser.parse_args()
+
+    device = usb.core.find(idVendor=VID, idProduct=PID)
+    if device is None:
+        sys.exit("device %04x:%04x not found" % (VID, PID))
+
+    if args.latency is not None:
+        device.ctrl_transfer(REQ_TYPE_VENDOR_OUT, REQ_LATENCY, args.latency, 0)
+        data = bytes(device.ctrl_transfer(REQ_TYPE_VENDOR_IN, REQ_LATENCY,
+                                          0, 0, 2))
+        print("latency %d ms" % struct.unpack("<H", data)[0])
+        return
+
+    taken = 0
+    while not args.count or taken < args.count:
+        data = bytes(device.ctrl_transfer(REQ_TYPE_VENDOR_IN, REQ_SNAPSHOT,
+                                          0, 0, 4096))
+        snapshot = decode(data)
+        print("#%d" % snapshot["sequence"])
+        for group, counters in snapshot["counters"].items():
+            print("  %-7s %s" % (group, " ".join(
+                "%s=%d" % item for item in counters.items())))
+        for probe, stats in snapshot.get("profile", {}).items():
+            print("  %-15s %s" % (probe, " ".join(
+                "%s=%d" % item for item in stats.items()
+                if item[0] != "buckets")))
+        taken += 1
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    main()
@@ -20,10 +20,17 @@
 #include "usblib/usbcdc.h"
 #include "usblib/device/usbdevice.h"
 #include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
 #include "utils/ustdlib.h"
 #include "utils/uartstdio.h"
 #include "usb_structs.h"
 #include "usbconfig.h"
+#include "usbevent.h"
+#include "usbcmd.h"
+#include "usbcompress.h"
+#include "usbpower.h"
+#include "usblog.h"
+#include "usbstack.h"
 
 // UART configuration for uartstdio library
 void ConfigureUART(void)
@@ -58,25 +65,103 @@ int main(void)
     // Enable the GPIO pins for the LED (PF2 & PF3).
     ROM_GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, GPIO_PIN_3|GPIO_PIN_2);
 
-    // Initialise UART for debug
+#ifndef USB_UART_BRIDGE
+    // Initialise UART for debug.  When bridging, the UART belongs to the
+    // USB driver instead.
     ConfigureUART();
+#endif
 
     // Initialise USBCDC for VCP.
     USBInit();
 
     while(1)
     {
-    	SysCtlSleep();
+        // Handle everything the USB interrupt has posted.
+        USBEventsProcess();
+
+        // Look for stack use below the deepest seen so far, for the
+        // telemetry snapshot.
+        USBStackPeak();
+
+        // Print the log to the console one record at a time, so that new
+        // events are never held up behind it.
+        if(USBLogPrint())
+        {
+            continue;
+        }
+
+        // Sleep until the next interrupt, in low power mode while the bus
+        // is suspended.
+        if(!USBEventPending())
+        {
+            USBPowerIdle();
+        }
+    }
+}
+
+// Status handler for the USB connection.  The green LED shows whether a host
+// has configured the device and is not suspended, as seen by the first port.
+void USBStatusHandler(uint32_t ui32Port, uint32_t ui32Event, uint32_t ui32Seq)
+{
+    if(ui32Port != 0)
+    {
+        return;
+    }
+
+    switch(ui32Event)
+    {
+        case USB_EVT_CONNECTED:
+        case USB_EVT_RESUME:
+            ROM_GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, GPIO_PIN_3);
+            break;
+        case USB_EVT_DISCONNECTED:
+        case USB_EVT_SUSPEND:
+            ROM_GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, 0);
+            break;
+        default:
+            break;
     }
 }
 
-// Data handler for RX channel
-void RxDataHandler()
+// Data handler for the RX channel of each port.  The received bytes are
+// echoed back on the same port straight out of the RX ring memory, or run as
+// commands with USB_COMMANDS.  With USB_COMPRESS the echo goes through the
+// compressor, so the host can switch it on.  Only as much as the TX buffer
+// can hold is taken; the rest stays queued and is picked up again on the
+// next TX completion.
+void RxDataHandler(uint32_t ui32Port)
+{
+#ifdef USB_COMMANDS
+    USBCmdProcess(&g_psRxBuffer[ui32Port], &g_psTxBuffer[ui32Port]);
+#elif defined(USB_COMPRESS)
+    USBCompressForward(ui32Port);
+#else
+    USBForward(&g_psRxBuffer[ui32Port], &g_psTxBuffer[ui32Port]);
+#endif
+}
+
+#ifdef USB_COMMANDS
+// Command handlers.  The table that maps names to these is generated by
+// host/cmdgen.py into usbcmd_table.h.
+void CmdPing(tUSBCmdReply *psReply, const char *pcArgs, uint32_t ui32ArgsLen)
+{
+    USBCmdReplyString(psReply, "pong\r\n");
+}
+
+void CmdEcho(tUSBCmdReply *psReply, const char *pcArgs, uint32_t ui32ArgsLen)
+{
+    USBCmdReplyWrite(psReply, pcArgs, ui32ArgsLen);
+    USBCmdReplyString(psReply, "\r\n");
+}
+
+void CmdStats(tUSBCmdReply *psReply, const char *pcArgs, uint32_t ui32ArgsLen)
 {
-	uint32_t numbytes;
-	uint8_t data[32];
-	numbytes = USBBufferDataAvailable(&RxBuffer);
-	USBBufferRead(&RxBuffer, data, numbytes);
-	USBBufferFlush(&RxBuffer);
-	USBBufferWrite(&TxBuffer, data, numbytes);
+    USBCmdReplyString(psReply, "rx ");
+    USBCmdReplyDecimal(psReply, g_psUSBBufferStats[0].ui32RxPeak);
+    USBCmdReplyString(psReply, " tx ");
+    USBCmdReplyDecimal(psReply, g_psUSBBufferStats[0].ui32TxPeak);
+    USBCmdReplyString(psReply, " lost ");
+    USBCmdReplyDecimal(psReply, g_ui32USBEventOverflows);
+    USBCmdReplyString(psReply, "\r\n");
 }
+#endif
@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
+#include "usbstack.h"
 
 //*****************************************************************************
 //
@@ -46,9 +47,10 @@ extern void _c_int00(void);
 
 //*****************************************************************************
 //
-// Linker variable that marks the top of the stack.
+// Linker variables that mark the bottom and the top of the stack.
 //
 //*****************************************************************************
+extern uint32_t __stack;
 extern uint32_t __STACK_TOP;
 
 //*****************************************************************************
@@ -57,6 +59,14 @@ extern uint32_t __STACK_TOP;
 //
 //*****************************************************************************
 extern void USB0DeviceIntHandler(void);
+extern void USBUARTIntHandler(void);
+extern void USBUARTPort1IntHandler(void);
+extern void USBUARTPort2IntHandler(void);
+extern void USBUARTFlowIntHandler(void);
+extern void USBTickHandler(void);
+extern void USBUARTDeferredIntHandler(void);
+extern void USBLatencyUSBIntHandler(void);
+extern void USBLatencyUARTIntHandler(void);
 
 //*****************************************************************************
 //
@@ -83,15 +93,15 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // SVCall handler
     IntDefaultHandler,                      // Debug monitor handler
     0,                                      // Reserved
-    IntDefaultHandler,                      // The PendSV handler
-    IntDefaultHandler,                      // The SysTick handler
+    USBUARTDeferredIntHandler,              // The PendSV handler
+    USBTickHandler,                         // The SysTick handler
     IntDefaultHandler,                      // GPIO Port A
-    IntDefaultHandler,                      // GPIO Port B
+    USBUARTFlowIntHandler,                  // GPIO Port B
     IntDefaultHandler,                      // GPIO Port C
-    IntDefaultHandler,                      // GPIO Port D
-    IntDefaultHandler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
-    IntDefaultHandler,                      // UART1 Rx and Tx
+    USBUARTFlowIntHandler,                  // GPIO Port D
+    USBUARTFlowIntHandler,                  // GPIO Port E
+    USBUARTIntHandler,                      // UART0 Rx and Tx
+    USBUARTPort1IntHandler,                 // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
     IntDefaultHandler,                      // PWM Fault
@@ -104,9 +114,9 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // ADC Sequence 2
     IntDefaultHandler,                      // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
-    IntDefaultHandler,                      // Timer 0 subtimer A
+    USBLatencyUSBIntHandler,                // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
-    IntDefaultHandler,                      // Timer 1 subtimer A
+    USBLatencyUARTIntHandler,               // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
     IntDefaultHandler,                      // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
@@ -144,7 +154,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port L
     IntDefaultHandler,                      // SSI2 Rx and Tx
     IntDefaultHandler,                      // SSI3 Rx and Tx
-    IntDefaultHandler,                      // UART3 Rx and Tx
+    USBUARTPort2IntHandler,                 // UART3 Rx and Tx
     IntDefaultHandler,                      // UART4 Rx and Tx
     IntDefaultHandler,                      // UART5 Rx and Tx
     IntDefaultHandler,                      // UART6 Rx and Tx
@@ -239,6 +249,20 @@ void (* const g_pfnVectors[])(void) =
 void
 ResetISR(void)
 {
+#ifdef USB_STACK_STATS
+    uint32_t *pui32Stack;
+
+    //
+    // Fill the stack with USB_STACK_PAINT so that USBStackPeak() can tell how
+    // much of it has been used.  The top 64 bytes, which this function may be
+    // using itself, are left alone.
+    //
+    for(pui32Stack = &__stack; pui32Stack < (&__STACK_TOP - 16); pui32Stack++)
+    {
+        *pui32Stack = USB_STACK_PAINT;
+    }
+#endif
+
     //
     // Jump to the CCS C initialization routine.  This will enable the
     // floating-point unit as well, so that does not need to be done here.
@@ -31,6 +31,7 @@
 #include "usblib/usb-ids.h"
 #include "usblib/device/usbdevice.h"
 #include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
 #include "usb_structs.h"
 
 //*****************************************************************************
@@ -152,64 +153,157 @@ uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
 // With the buffer in place, the CDC channel callback is set to the relevant
 // channel function and the callback data is set to point to the channel
 // instance data. The buffer, in turn, has its callback set to the application
-// function and the callback data set to our CDC instance structure.
+// function and the callback data set to our CDC instance structure.  There is
+// one instance per port and the handlers tell the ports apart by it.
 //
 //*****************************************************************************
-extern const tUSBBuffer TxBuffer;
-extern const tUSBBuffer RxBuffer;
+#if USB_PORTS > 1
+#define USB_PID_PORTS           USB_PID_COMP_SERIAL
+#else
+#define USB_PID_PORTS           USB_PID_SERIAL
+#endif
 
-tUSBDCDCDevice g_sCDCDevice =
+#define CDC_DEVICE(n)                                                         \
+    {                                                                         \
+        USB_VID_TI_1CBE,                                                      \
+        USB_PID_PORTS,                                                        \
+        0,                                                                    \
+        USB_CONF_ATTR_SELF_PWR,                                               \
+        ControlHandler,                                                       \
+        (void *)&g_psCDCDevice[n],                                            \
+        USBBufferEventCallback,                                               \
+        (void *)&g_psRxBuffer[n],                                             \
+        USBBufferEventCallback,                                               \
+        (void *)&g_psTxBuffer[n],                                             \
+        g_ppui8StringDescriptors,                                             \
+        NUM_STRING_DESCRIPTORS                                                \
+    }
+
+tUSBDCDCDevice g_psCDCDevice[USB_PORTS] =
+{
+    CDC_DEVICE(0),
+#if USB_PORTS > 1
+    CDC_DEVICE(1),
+#endif
+#if USB_PORTS > 2
+    CDC_DEVICE(2),
+#endif
+};
+
+#if USB_PORTS > 1
+//*****************************************************************************
+//
+// The composite device made of the CDC instances above.  The entries and the
+// descriptor space are filled in by USBDCDCCompositeInit() and
+// USBDCompositeInit().
+//
+//*****************************************************************************
+tCompositeEntry g_psCompEntries[USB_PORTS];
+uint8_t g_pui8CompDescriptor[USB_COMP_DESCRIPTOR_SIZE];
+
+tUSBDCompositeDevice g_sCompDevice =
 {
     USB_VID_TI_1CBE,
-    USB_PID_SERIAL,
+    USB_PID_COMP_SERIAL,
     0,
     USB_CONF_ATTR_SELF_PWR,
-    ControlHandler,
-    (void *)&g_sCDCDevice,
-    USBBufferEventCallback,
-    (void *)&RxBuffer,
-    USBBufferEventCallback,
-    (void *)&TxBuffer,
+    0,
     g_ppui8StringDescriptors,
-    NUM_STRING_DESCRIPTORS
+    NUM_STRING_DESCRIPTORS,
+    USB_PORTS,
+    g_psCompEntries
+};
+#endif
+
+//*****************************************************************************
+//
+// Storage shared by the receive and transmit buffers of each port.  It
+// starts out split evenly between the two; USBBufferRebalance() in
+// usbconfig.c moves the split in USB_BUFFER_BLOCK_SIZE steps while both
+// buffers are empty.  The arenas are word aligned, and so is every split
+// point, so that USBCopy() can move data between them a word at a time.
+//
+//*****************************************************************************
+#pragma DATA_ALIGN(g_pui8Port0Arena, 4)
+static uint8_t g_pui8Port0Arena[USB_PORT0_ARENA_SIZE];
+#if USB_PORTS > 1
+#pragma DATA_ALIGN(g_pui8Port1Arena, 4)
+static uint8_t g_pui8Port1Arena[USB_PORT1_ARENA_SIZE];
+#endif
+#if USB_PORTS > 2
+#pragma DATA_ALIGN(g_pui8Port2Arena, 4)
+static uint8_t g_pui8Port2Arena[USB_PORT2_ARENA_SIZE];
+#endif
+
+const tUSBBufferArena g_psUSBBufferArena[USB_PORTS] =
+{
+    { g_pui8Port0Arena, USB_PORT0_ARENA_SIZE },
+#if USB_PORTS > 1
+    { g_pui8Port1Arena, USB_PORT1_ARENA_SIZE },
+#endif
+#if USB_PORTS > 2
+    { g_pui8Port2Arena, USB_PORT2_ARENA_SIZE },
+#endif
 };
 
 //*****************************************************************************
 //
-// Receive buffer (from the USB perspective).
+// Receive buffers (from the USB perspective).
 //
 //*****************************************************************************
-uint8_t g_pui8USBRxBuffer[USB_BUFFER_SIZE];
-uint8_t g_pui8RxBufferWorkspace[USB_BUFFER_WORKSPACE_SIZE];
-const tUSBBuffer RxBuffer =
+static uint8_t g_ppui8RxBufferWorkspace[USB_PORTS][USB_BUFFER_WORKSPACE_SIZE];
+
+#define RX_BUFFER(n)                                                          \
+    {                                                                         \
+        false,                          /* This is a receive buffer. */       \
+        RxHandler,                      /* pfnCallback */                     \
+        (void *)&g_psCDCDevice[n],      /* Callback data is our device. */    \
+        USBDCDCPacketRead,              /* pfnTransfer */                     \
+        USBDCDCRxPacketAvailable,       /* pfnAvailable */                    \
+        (void *)&g_psCDCDevice[n],      /* pvHandle */                        \
+        g_pui8Port##n##Arena,           /* pui8Buffer */                      \
+        USB_PORT##n##_ARENA_SIZE / 2,   /* ui32BufferSize */                  \
+        g_ppui8RxBufferWorkspace[n]     /* pvWorkspace */                     \
+    }
+
+tUSBBuffer g_psRxBuffer[USB_PORTS] =
 {
-    false,                          // This is a receive buffer.
-    RxHandler,                      // pfnCallback
-    (void *)&g_sCDCDevice,          // Callback data is our device pointer.
-    USBDCDCPacketRead,              // pfnTransfer
-    USBDCDCRxPacketAvailable,       // pfnAvailable
-    (void *)&g_sCDCDevice,          // pvHandle
-    g_pui8USBRxBuffer,              // pui8Buffer
-    USB_BUFFER_SIZE,               // ui32BufferSize
-    g_pui8RxBufferWorkspace         // pvWorkspace
+    RX_BUFFER(0),
+#if USB_PORTS > 1
+    RX_BUFFER(1),
+#endif
+#if USB_PORTS > 2
+    RX_BUFFER(2),
+#endif
 };
 
 //*****************************************************************************
 //
-// Transmit buffer (from the USB perspective).
+// Transmit buffers (from the USB perspective).
 //
 //*****************************************************************************
-uint8_t g_pui8USBTxBuffer[USB_BUFFER_SIZE];
-uint8_t g_pui8TxBufferWorkspace[USB_BUFFER_WORKSPACE_SIZE];
-const tUSBBuffer TxBuffer =
+static uint8_t g_ppui8TxBufferWorkspace[USB_PORTS][USB_BUFFER_WORKSPACE_SIZE];
+
+#define TX_BUFFER(n)                                                          \
+    {                                                                         \
+        true,                           /* This is a transmit buffer. */      \
+        TxHandler,                      /* pfnCallback */                     \
+        (void *)&g_psCDCDevice[n],      /* Callback data is our device. */    \
+        TxPacketWrite,                  /* pfnTransfer */                     \
+        USBDCDCTxPacketAvailable,       /* pfnAvailable */                    \
+        (void *)&g_psCDCDevice[n],      /* pvHandle */                        \
+        &g_pui8Port##n##Arena[USB_PORT##n##_ARENA_SIZE / 2], /* pui8Buffer */ \
+        USB_PORT##n##_ARENA_SIZE / 2,   /* ui32BufferSize */                  \
+        g_ppui8TxBufferWorkspace[n]     /* pvWorkspace */                     \
+    }
+
+tUSBBuffer g_psTxBuffer[USB_PORTS] =
 {
-    true,                           // This is a transmit buffer.
-    TxHandler,                      // pfnCallback
-    (void *)&g_sCDCDevice,          // Callback data is our device pointer.
-    USBDCDCPacketWrite,             // pfnTransfer
-    USBDCDCTxPacketAvailable,       // pfnAvailable
-    (void *)&g_sCDCDevice,          // pvHandle
-    g_pui8USBTxBuffer,              // pui8Buffer
-    USB_BUFFER_SIZE,               // ui32BufferSize
-    g_pui8TxBufferWorkspace         // pvWorkspace
+    TX_BUFFER(0),
+#if USB_PORTS > 1
+    TX_BUFFER(1),
+#endif
+#if USB_PORTS > 2
+    TX_BUFFER(2),
+#endif
 };
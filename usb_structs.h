@@ -27,23 +27,94 @@
 
 //*****************************************************************************
 //
-// The size of the transmit and receive buffers used for the redirected UART.
-// This number should be a power of 2 for best performance.  256 is chosen
-// pretty much at random though the buffer should be at least twice the size of
-// a maxmum-sized USB packet.
+// Comment this out, or build with USB_SINGLE_BUFFER defined, to use
+// single-packet FIFOs for the CDC bulk data endpoints.  With double buffering
+// one packet can be received or sent by the USB controller while the
+// previous one is being processed, so the endpoints are no longer NAKed
+// while the RX and TX handlers run.
 //
 //*****************************************************************************
-#define USB_BUFFER_SIZE 256
+#ifndef USB_SINGLE_BUFFER
+#define USB_DOUBLE_BUFFER
+#endif
+
+#ifdef USB_DOUBLE_BUFFER
+#define USB_FIFO_PACKETS        2
+#else
+#define USB_FIFO_PACKETS        1
+#endif
+
+//*****************************************************************************
+//
+// Number of serial ports.  With more than one the device becomes a composite
+// of USB_PORTS CDC ACM functions, each with its own buffers, line coding and,
+// in a bridge, its own UART.  Every port takes three endpoints, so the USB
+// controller has room for three ports at most.
+//
+//*****************************************************************************
+#define USB_PORTS               1
+
+#if (USB_PORTS < 1) || (USB_PORTS > 3)
+#error USB_PORTS must be between 1 and 3
+#endif
+
+//*****************************************************************************
+//
+// The transmit and receive buffers of each port share a single arena which
+// is carved into blocks of one maximum-sized USB packet.  Each buffer always
+// keeps at least USB_BUFFER_MIN_BLOCKS blocks, enough for every packet the
+// endpoint FIFO can hold plus the one the application is working on; the
+// remainder is lent at run time to whichever direction is running out of
+// space more often.  USB_PORTn_ARENA_SIZE sets the RAM given to port n; the
+// default uses the same RAM as the original pair of 256 byte buffers.
+//
+//*****************************************************************************
+#define USB_BUFFER_BLOCK_SIZE   64
+#define USB_BUFFER_MIN_BLOCKS   (USB_FIFO_PACKETS + 1)
+#define USB_PORT0_ARENA_SIZE    512
+#define USB_PORT1_ARENA_SIZE    512
+#define USB_PORT2_ARENA_SIZE    512
+
+#define USB_BUFFER_ARENA_CHECK(n)                                             \
+        (((USB_PORT##n##_ARENA_SIZE % USB_BUFFER_BLOCK_SIZE) == 0) &&         \
+         ((USB_PORT##n##_ARENA_SIZE / USB_BUFFER_BLOCK_SIZE) >=               \
+          (2 * USB_BUFFER_MIN_BLOCKS)))
+
+#if !USB_BUFFER_ARENA_CHECK(0) || !USB_BUFFER_ARENA_CHECK(1) ||               \
+    !USB_BUFFER_ARENA_CHECK(2)
+#error Each USB_PORTn_ARENA_SIZE must be a multiple of USB_BUFFER_BLOCK_SIZE \
+       big enough for both buffers
+#endif
+
+// The RAM shared by the buffers of one port.
+typedef struct
+{
+    uint8_t *pui8Data;
+    uint32_t ui32Size;
+} tUSBBufferArena;
 
 extern uint32_t RxHandler(void *pvCBData, uint32_t ui32Event,
                           uint32_t ui32MsgValue, void *pvMsgData);
 extern uint32_t TxHandler(void *pvi32CBData, uint32_t ui32Event,
                           uint32_t ui32MsgValue, void *pvMsgData);
+extern uint32_t TxPacketWrite(void *pvHandle, uint8_t *pui8Data,
+                              uint32_t ui32Size, bool bLast);
+
+extern tUSBBuffer g_psTxBuffer[USB_PORTS];
+extern tUSBBuffer g_psRxBuffer[USB_PORTS];
+extern tUSBDCDCDevice g_psCDCDevice[USB_PORTS];
+extern const tUSBBufferArena g_psUSBBufferArena[USB_PORTS];
+#if USB_PORTS > 1
+extern tUSBDCompositeDevice g_sCompDevice;
+extern tCompositeEntry g_psCompEntries[USB_PORTS];
+extern uint8_t g_pui8CompDescriptor[];
+#define USB_COMP_DESCRIPTOR_SIZE    (COMPOSITE_DCDC_SIZE * USB_PORTS)
+#endif
 
-extern const tUSBBuffer TxBuffer;
-extern const tUSBBuffer RxBuffer;
-extern tUSBDCDCDevice g_sCDCDevice;
-extern uint8_t g_pui8USBTxBuffer[];
-extern uint8_t g_pui8USBRxBuffer[];
+// The buffers and device of the first port under the names used by
+// single-port applications.
+#define TxBuffer                g_psTxBuffer[0]
+#define RxBuffer                g_psRxBuffer[0]
+#define g_sCDCDevice            g_psCDCDevice[0]
 
 #endif
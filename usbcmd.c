@@ -0,0 +1,264 @@
+/*
+ * usbcmd.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbcmd.h"
+
+#ifdef USB_COMMANDS
+
+#include "usbcmd_table.h"
+
+// Lines that wrap from the end of the RX ring to its start are put back
+// together here.  All other lines are parsed in place.
+static char g_pcCmdLine[USB_CMD_LINE_SIZE];
+
+// Set while the rest of an over-long line is being thrown away.
+static bool g_bCmdDiscard;
+
+// Hash a command name into a slot of the command table.  This must match
+// cmd_hash() in host/cmdgen.py.
+static uint32_t CmdHash(const char *pcName, uint32_t ui32Length)
+{
+    uint32_t ui32Hash;
+
+    ui32Hash = USB_CMD_HASH_SEED;
+    while(ui32Length--)
+    {
+        ui32Hash = (ui32Hash ^ (uint8_t)*pcName++) * 0x01000193;
+    }
+
+    return(ui32Hash >> (32 - USB_CMD_HASH_BITS));
+}
+
+// Look up and run the command on one line.
+static void CmdDispatch(tUSBCmdReply *psReply, const char *pcLine,
+                        uint32_t ui32Length)
+{
+    const tUSBCmd *psCmd;
+    uint32_t ui32Name;
+
+    // The name runs up to the first space and the arguments start after the
+    // spaces following it.
+    for(ui32Name = 0; (ui32Name < ui32Length) && (pcLine[ui32Name] != ' ');
+        ui32Name++)
+    {
+    }
+
+    // One hash and one compare decide whether the command exists.
+    psCmd = &g_psUSBCmdTable[CmdHash(pcLine, ui32Name)];
+    if(!psCmd->pcName || (psCmd->ui32Length != ui32Name) ||
+       memcmp(psCmd->pcName, pcLine, ui32Name))
+    {
+        USBCmdReplyString(psReply, "ERR unknown command\r\n");
+        return;
+    }
+
+    while((ui32Name < ui32Length) && (pcLine[ui32Name] == ' '))
+    {
+        ui32Name++;
+    }
+    psCmd->pfnHandler(psReply, &pcLine[ui32Name], ui32Length - ui32Name);
+}
+
+// Find the first line ending in a run of bytes.  Returns the offset of the
+// '\r' or '\n', or ui32Size if there is none.
+static uint32_t CmdLineEnd(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < ui32Size; ui32Idx++)
+    {
+        if((pui8Data[ui32Idx] == '\n') || (pui8Data[ui32Idx] == '\r'))
+        {
+            break;
+        }
+    }
+
+    return(ui32Idx);
+}
+
+//*****************************************************************************
+//
+// Run every complete command line waiting in the RX buffer.
+//
+// \param psRx is the buffer the commands are read from.
+// \param psTx is the buffer replies are written to.
+//
+// Lines end with '\r' or '\n' and empty lines are ignored.  Each line is
+// looked up in the command table and its handler writes the reply straight
+// into the TX buffer.  A line is only handled once USB_CMD_REPLY_SIZE bytes
+// are free in the TX buffer; otherwise it stays queued and is handled when
+// RxDataHandler() is called again after the next TX completion.  Incomplete
+// lines are left in the RX buffer until the rest arrives.  The replies are
+// flushed to the host once all complete lines have been handled.
+//
+// \return Returns the number of lines handled.
+//
+//*****************************************************************************
+uint32_t USBCmdProcess(const tUSBBuffer *psRx, const tUSBBuffer *psTx)
+{
+    tUSBSpan psSpans[2];
+    tUSBCmdReply sReply;
+    const char *pcLine;
+    uint32_t ui32Avail, ui32Length, ui32Lines;
+
+    ui32Lines = 0;
+
+    while(1)
+    {
+        ui32Avail = USBRxSpansGet(psRx, psSpans);
+        if(!ui32Avail ||
+           (USBTxSpansGet(psTx, sReply.psSpans) < USB_CMD_REPLY_SIZE))
+        {
+            break;
+        }
+
+        // Most lines lie in the first span and are parsed where they are.
+        // One that wraps is copied to g_pcCmdLine if it fits.
+        pcLine = (const char *)psSpans[0].pui8Data;
+        ui32Length = CmdLineEnd(psSpans[0].pui8Data, psSpans[0].ui32Size);
+        if(ui32Length == psSpans[0].ui32Size)
+        {
+            ui32Length += CmdLineEnd(psSpans[1].pui8Data, psSpans[1].ui32Size);
+            if((ui32Length < ui32Avail) && (ui32Length <= USB_CMD_LINE_SIZE))
+            {
+                USBCopy((uint8_t *)g_pcCmdLine, psSpans[0].pui8Data,
+                        psSpans[0].ui32Size);
+                USBCopy((uint8_t *)&g_pcCmdLine[psSpans[0].ui32Size],
+                        psSpans[1].pui8Data, ui32Length - psSpans[0].ui32Size);
+                pcLine = g_pcCmdLine;
+            }
+        }
+
+        if(ui32Length == ui32Avail)
+        {
+            // No line ending yet.  Wait for more unless the line is already
+            // too long, in which case drop what there is so far.
+            if(ui32Avail <= USB_CMD_LINE_SIZE)
+            {
+                break;
+            }
+            g_bCmdDiscard = true;
+            USBRxConsume(psRx, ui32Avail);
+            continue;
+        }
+
+        sReply.ui32Used = 0;
+        sReply.ui32Free = USB_CMD_REPLY_SIZE;
+
+        if(g_bCmdDiscard || (ui32Length > USB_CMD_LINE_SIZE))
+        {
+            g_bCmdDiscard = false;
+            USBCmdReplyString(&sReply, "ERR line too long\r\n");
+            ui32Lines++;
+        }
+        else if(ui32Length)
+        {
+            CmdDispatch(&sReply, pcLine, ui32Length);
+            ui32Lines++;
+        }
+
+        USBTxCommit(psTx, sReply.ui32Used);
+        USBRxConsume(psRx, ui32Length + 1);
+    }
+
+    // Replies are complete, so do not hold them back for the latency timer.
+    if(ui32Lines)
+    {
+        USBTxFlush(psTx);
+    }
+
+    return(ui32Lines);
+}
+
+// Add bytes to a reply.  Anything that does not fit is dropped.
+void USBCmdReplyWrite(tUSBCmdReply *psReply, const char *pcData,
+                      uint32_t ui32Size)
+{
+    uint32_t ui32Chunk;
+
+    if(ui32Size > (psReply->ui32Free - psReply->ui32Used))
+    {
+        ui32Size = psReply->ui32Free - psReply->ui32Used;
+    }
+
+    if(psReply->ui32Used < psReply->psSpans[0].ui32Size)
+    {
+        ui32Chunk = psReply->psSpans[0].ui32Size - psReply->ui32Used;
+        if(ui32Chunk > ui32Size)
+        {
+            ui32Chunk = ui32Size;
+        }
+        USBCopy(&psReply->psSpans[0].pui8Data[psReply->ui32Used],
+                (const uint8_t *)pcData, ui32Chunk);
+        psReply->ui32Used += ui32Chunk;
+        pcData += ui32Chunk;
+        ui32Size -= ui32Chunk;
+    }
+
+    if(ui32Size)
+    {
+        USBCopy(&psReply->psSpans[1].pui8Data[psReply->ui32Used -
+                                              psReply->psSpans[0].ui32Size],
+                (const uint8_t *)pcData, ui32Size);
+        psReply->ui32Used += ui32Size;
+    }
+}
+
+// Add a NUL terminated string to a reply.
+void USBCmdReplyString(tUSBCmdReply *psReply, const char *pcString)
+{
+    USBCmdReplyWrite(psReply, pcString, strlen(pcString));
+}
+
+// Add an unsigned number in decimal to a reply.
+void USBCmdReplyDecimal(tUSBCmdReply *psReply, uint32_t ui32Value)
+{
+    char pcDigits[10];
+    uint32_t ui32Idx;
+
+    ui32Idx = sizeof(pcDigits);
+    do
+    {
+        pcDigits[--ui32Idx] = '0' + (ui32Value % 10);
+        ui32Value /= 10;
+    }
+    while(ui32Value);
+
+    USBCmdReplyWrite(psReply, &pcDigits[ui32Idx], sizeof(pcDigits) - ui32Idx);
+}
+
+// List the commands.
+void USBCmdHelp(tUSBCmdReply *psReply, const char *pcArgs,
+                uint32_t ui32ArgsLen)
+{
+    uint32_t ui32Idx;
+
+    for(ui32Idx = 0; ui32Idx < (1 << USB_CMD_HASH_BITS); ui32Idx++)
+    {
+        if(g_psUSBCmdTable[ui32Idx].pcName)
+        {
+            USBCmdReplyWrite(psReply, g_psUSBCmdTable[ui32Idx].pcName,
+                             g_psUSBCmdTable[ui32Idx].ui32Length);
+            USBCmdReplyWrite(psReply, " ", 1);
+        }
+    }
+    USBCmdReplyWrite(psReply, "\r\n", 2);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * usbcmd.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBCMD_H_
+#define USBCMD_H_
+
+// Uncomment to run the line command interpreter on the RX channel instead of
+// echoing the data back.
+//#define USB_COMMANDS
+
+// Longest command line, excluding the line ending.  Longer lines are thrown
+// away with an error reply.
+#define USB_CMD_LINE_SIZE       64
+
+// Space that must be free in the TX buffer before a line is handled.  No
+// reply may be longer than this; anything beyond it is cut off.
+#define USB_CMD_REPLY_SIZE      64
+
+// Where a command handler writes its reply: the free space of the TX buffer,
+// which may wrap from the first span into the second.
+typedef struct
+{
+    tUSBSpan psSpans[2];
+    uint32_t ui32Used;
+    uint32_t ui32Free;
+} tUSBCmdReply;
+
+// A command handler.  pcArgs is everything after the command name and the
+// spaces following it; it is not NUL terminated.
+typedef void (* tUSBCmdHandler)(tUSBCmdReply *psReply, const char *pcArgs,
+                                uint32_t ui32ArgsLen);
+
+// An entry of the command table.  Unused slots have a NULL name.
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Length;
+    tUSBCmdHandler pfnHandler;
+} tUSBCmd;
+
+uint32_t USBCmdProcess(const tUSBBuffer *psRx, const tUSBBuffer *psTx);
+void USBCmdReplyWrite(tUSBCmdReply *psReply, const char *pcData,
+                      uint32_t ui32Size);
+void USBCmdReplyString(tUSBCmdReply *psReply, const char *pcString);
+void USBCmdReplyDecimal(tUSBCmdReply *psReply, uint32_t ui32Value);
+
+// Built-in command listing every command in the table.
+void USBCmdHelp(tUSBCmdReply *psReply, const char *pcArgs,
+                uint32_t ui32ArgsLen);
+
+#endif /* USBCMD_H_ */
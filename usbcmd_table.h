@@ -0,0 +1,29 @@
+/*
+ * usbcmd_table.h
+ *
+ * Generated by host/cmdgen.py help:USBCmdHelp ping:CmdPing echo:CmdEcho stats:CmdStats
+ * Do not edit; rerun the command above instead.
+ */
+
+#ifndef USBCMD_TABLE_H_
+#define USBCMD_TABLE_H_
+
+extern void CmdEcho(tUSBCmdReply *psReply, const char *pcArgs,
+        uint32_t ui32ArgsLen);
+extern void CmdPing(tUSBCmdReply *psReply, const char *pcArgs,
+        uint32_t ui32ArgsLen);
+extern void CmdStats(tUSBCmdReply *psReply, const char *pcArgs,
+        uint32_t ui32ArgsLen);
+
+#define USB_CMD_HASH_BITS       2
+#define USB_CMD_HASH_SEED       0x811C9DC9
+
+static const tUSBCmd g_psUSBCmdTable[1 << USB_CMD_HASH_BITS] =
+{
+    { "stats", 5, CmdStats },
+    { "ping", 4, CmdPing },
+    { "help", 4, USBCmdHelp },
+    { "echo", 4, CmdEcho },
+};
+
+#endif /* USBCMD_TABLE_H_ */
@@ -0,0 +1,440 @@
+/*
+ * usbcompress.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbcompress.h"
+
+// Compression counters, per port.  They stay zero without USB_COMPRESS.
+tUSBCompressStats g_psUSBCompressStats[USB_PORTS];
+
+#ifdef USB_COMPRESS
+
+// LZ4 block format limits.  A match is at least MIN_MATCH bytes long, the
+// last match starts at least MF_LIMIT bytes before the end of the block and
+// the last LAST_LITERALS bytes are always literals.
+#define MIN_MATCH               4
+#define MF_LIMIT                12
+#define LAST_LITERALS           5
+
+// Largest coded block, header included.  Data that does not shrink is stored
+// instead, but the coder may still run past the input size before giving up.
+#define CODED_SIZE_MAX                                                        \
+        (USB_COMPRESS_HEADER_SIZE + USB_COMPRESS_BLOCK_SIZE +                 \
+         (USB_COMPRESS_BLOCK_SIZE / 255) + 16)
+
+#if USB_COMPRESS_BLOCK_SIZE > 256
+#error USB_COMPRESS_BLOCK_SIZE must be at most 256
+#endif
+
+//*****************************************************************************
+//
+// State of one port's compressor.  Everything but the two request flags is
+// only touched from the main loop.  The input block collects the data
+// written; once it is coded the result waits in pui8Coded until all of it has
+// gone into the transmit buffer, and only then is the next block started.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint8_t pui8Input[USB_COMPRESS_BLOCK_SIZE];
+    uint8_t pui8Coded[CODED_SIZE_MAX];
+    uint32_t ui32InputSize;
+    uint32_t ui32CodedSize;
+    uint32_t ui32CodedSent;
+
+    // The partial block is to be sent once the coded one has gone.
+    bool bFlush;
+
+    // Whether data is being compressed, and what the host asked for.  The
+    // request is applied by the writer on a block boundary.
+    bool bEnabled;
+    volatile bool bRequested;
+    volatile bool bReset;
+} tUSBCompressState;
+
+static tUSBCompressState g_psCompressState[USB_PORTS];
+
+// Hash of the four bytes at each position to the last position they were
+// seen at.  Only one block is coded at a time, so the ports share it.
+static uint8_t g_pui8CompressHash[1 << USB_COMPRESS_HASH_BITS];
+
+// Four bytes at any address, as in USBCopy().
+typedef struct __attribute__((packed))
+{
+    uint32_t ui32Word;
+} tUnalignedWord;
+
+#define READ32(pui8Data)    (((const tUnalignedWord *)(pui8Data))->ui32Word)
+#define HASH(ui32Word)                                                        \
+        (((ui32Word) * 2654435761U) >> (32 - USB_COMPRESS_HASH_BITS))
+
+// Write an LZ4 length extension: the part of a length beyond the 15 that
+// fits in the token, as bytes of 255 followed by the remainder.
+static uint8_t *LengthWrite(uint8_t *pui8Out, uint32_t ui32Length)
+{
+    ui32Length -= 15;
+    while(ui32Length >= 255)
+    {
+        *pui8Out++ = 255;
+        ui32Length -= 255;
+    }
+    *pui8Out++ = (uint8_t)ui32Length;
+    return(pui8Out);
+}
+
+// Write one LZ4 sequence: the literals, then a match of ui32Match bytes
+// ui32Offset back, or no match at all for the last sequence of a block.
+static uint8_t *SequenceWrite(uint8_t *pui8Out, const uint8_t *pui8Literals,
+                              uint32_t ui32Literals, uint32_t ui32Offset,
+                              uint32_t ui32Match)
+{
+    uint8_t *pui8Token;
+
+    pui8Token = pui8Out++;
+    *pui8Token = (ui32Literals < 15) ? (uint8_t)(ui32Literals << 4) : 0xF0;
+    if(ui32Literals >= 15)
+    {
+        pui8Out = LengthWrite(pui8Out, ui32Literals);
+    }
+    USBCopy(pui8Out, pui8Literals, ui32Literals);
+    pui8Out += ui32Literals;
+
+    if(ui32Match)
+    {
+        *pui8Out++ = (uint8_t)ui32Offset;
+        *pui8Out++ = (uint8_t)(ui32Offset >> 8);
+        ui32Match -= MIN_MATCH;
+        *pui8Token |= (ui32Match < 15) ? (uint8_t)ui32Match : 0x0F;
+        if(ui32Match >= 15)
+        {
+            pui8Out = LengthWrite(pui8Out, ui32Match);
+        }
+    }
+    return(pui8Out);
+}
+
+//*****************************************************************************
+//
+// Codes a block as an LZ4 block.
+//
+// \param pui8In is the data.
+// \param ui32Size is the number of bytes of data, at most a block.
+// \param pui8Out receives the coded data.
+//
+// This is the greedy single probe matcher of the LZ4 fast mode: every
+// position is looked up in the hash table and the candidate taken if its
+// first four bytes match.  Matches are not extended backwards and never
+// reach before the start of the block.
+//
+// \return Returns the number of bytes written to pui8Out.
+//
+//*****************************************************************************
+static uint32_t BlockCode(const uint8_t *pui8In, uint32_t ui32Size,
+                          uint8_t *pui8Out)
+{
+    uint32_t ui32Pos, ui32Anchor, ui32Candidate, ui32Match, ui32Hash;
+    uint8_t *pui8Start;
+
+    pui8Start = pui8Out;
+    ui32Pos = ui32Anchor = 0;
+    memset(g_pui8CompressHash, 0, sizeof(g_pui8CompressHash));
+
+    while((ui32Pos + MF_LIMIT) <= ui32Size)
+    {
+        ui32Hash = HASH(READ32(&pui8In[ui32Pos]));
+        ui32Candidate = g_pui8CompressHash[ui32Hash];
+        g_pui8CompressHash[ui32Hash] = (uint8_t)ui32Pos;
+
+        if((ui32Candidate >= ui32Pos) ||
+           (READ32(&pui8In[ui32Candidate]) != READ32(&pui8In[ui32Pos])))
+        {
+            ui32Pos++;
+            continue;
+        }
+
+        ui32Match = MIN_MATCH;
+        while(((ui32Pos + ui32Match) < (ui32Size - LAST_LITERALS)) &&
+              (pui8In[ui32Candidate + ui32Match] ==
+               pui8In[ui32Pos + ui32Match]))
+        {
+            ui32Match++;
+        }
+
+        pui8Out = SequenceWrite(pui8Out, &pui8In[ui32Anchor],
+                                ui32Pos - ui32Anchor,
+                                ui32Pos - ui32Candidate, ui32Match);
+        ui32Pos += ui32Match;
+        ui32Anchor = ui32Pos;
+    }
+
+    pui8Out = SequenceWrite(pui8Out, &pui8In[ui32Anchor],
+                            ui32Size - ui32Anchor, 0, 0);
+    return(pui8Out - pui8Start);
+}
+
+// Code the input block of a port into its coded buffer, header and all.  The
+// block is stored as-is if coding does not make it smaller.
+static void BlockFinish(uint32_t ui32Port)
+{
+    tUSBCompressState *psState;
+    tUSBCompressStats *psStats;
+    uint32_t ui32Start, ui32Size, ui32Coded;
+
+    psState = &g_psCompressState[ui32Port];
+    psStats = &g_psUSBCompressStats[ui32Port];
+    ui32Start = USBTimeGet();
+    ui32Size = psState->ui32InputSize;
+
+    ui32Coded = BlockCode(psState->pui8Input, ui32Size,
+                          &psState->pui8Coded[USB_COMPRESS_HEADER_SIZE]);
+    if(ui32Coded >= ui32Size)
+    {
+        USBCopy(&psState->pui8Coded[USB_COMPRESS_HEADER_SIZE],
+                psState->pui8Input, ui32Size);
+        ui32Coded = ui32Size;
+        psStats->ui32StoredBlocks++;
+        psState->pui8Coded[3] = USB_COMPRESS_STORED >> 8;
+    }
+    else
+    {
+        psState->pui8Coded[3] = 0;
+    }
+    psState->pui8Coded[0] = (uint8_t)ui32Size;
+    psState->pui8Coded[1] = (uint8_t)(ui32Size >> 8);
+    psState->pui8Coded[2] = (uint8_t)ui32Coded;
+    psState->pui8Coded[3] |= (uint8_t)(ui32Coded >> 8);
+
+    psState->ui32CodedSize = ui32Coded + USB_COMPRESS_HEADER_SIZE;
+    psState->ui32CodedSent = 0;
+    psState->ui32InputSize = 0;
+
+    psStats->ui32RawBytes += ui32Size;
+    psStats->ui32CodedBytes += psState->ui32CodedSize;
+    psStats->ui32Blocks++;
+    psStats->ui32Time += USBTimeGet() - ui32Start;
+}
+
+// Move as much of a port's coded block as fits into its transmit buffer.
+// Returns true if some of it is still left.
+static bool CodedSend(uint32_t ui32Port)
+{
+    tUSBCompressState *psState;
+    tUSBSpan psSpans[2];
+    uint32_t ui32Count, ui32Chunk;
+    const uint8_t *pui8Coded;
+
+    psState = &g_psCompressState[ui32Port];
+    ui32Count = psState->ui32CodedSize - psState->ui32CodedSent;
+    if(!ui32Count)
+    {
+        return(false);
+    }
+
+    ui32Chunk = USBTxSpansGet(&g_psTxBuffer[ui32Port], psSpans);
+    if(ui32Count > ui32Chunk)
+    {
+        ui32Count = ui32Chunk;
+    }
+    pui8Coded = &psState->pui8Coded[psState->ui32CodedSent];
+
+    ui32Chunk = (ui32Count < psSpans[0].ui32Size) ? ui32Count :
+                psSpans[0].ui32Size;
+    USBCopy(psSpans[0].pui8Data, pui8Coded, ui32Chunk);
+    USBCopy(psSpans[1].pui8Data, &pui8Coded[ui32Chunk], ui32Count - ui32Chunk);
+    USBTxCommit(&g_psTxBuffer[ui32Port], ui32Count);
+
+    psState->ui32CodedSent += ui32Count;
+    if(psState->ui32CodedSent != psState->ui32CodedSize)
+    {
+        return(true);
+    }
+    psState->ui32CodedSize = psState->ui32CodedSent = 0;
+    return(false);
+}
+
+// Apply a reset or a change of mode asked for by the host.  A reset drops
+// whatever is still waiting, since the transmit buffer has been flushed or
+// the client that wanted it has gone.  Otherwise the mode only changes once
+// everything written so far has been sent the old way.  Returns true if the
+// port is compressing.
+static bool ModeUpdate(uint32_t ui32Port)
+{
+    tUSBCompressState *psState;
+
+    psState = &g_psCompressState[ui32Port];
+    if(psState->bReset)
+    {
+        psState->bReset = false;
+        psState->bEnabled = false;
+        psState->ui32InputSize = 0;
+        psState->ui32CodedSize = psState->ui32CodedSent = 0;
+        psState->bFlush = false;
+    }
+
+    if(psState->bRequested != psState->bEnabled)
+    {
+        if(psState->ui32InputSize && !psState->ui32CodedSize)
+        {
+            BlockFinish(ui32Port);
+        }
+        if(!CodedSend(ui32Port))
+        {
+            psState->bEnabled = psState->bRequested;
+            psState->bFlush = false;
+        }
+    }
+    return(psState->bEnabled);
+}
+
+// Switch compression of a port on or off.  This may be called from any
+// context; the switch happens with the next write or flush.
+void USBCompressRequest(uint32_t ui32Port, bool bEnable)
+{
+    g_psCompressState[ui32Port].bRequested = bEnable;
+}
+
+// Switch compression of a port off and discard anything not yet sent.  Called
+// from the USB interrupt when the device is configured or DTR drops.
+void USBCompressReset(uint32_t ui32Port)
+{
+    g_psCompressState[ui32Port].bRequested = false;
+    g_psCompressState[ui32Port].bReset = true;
+}
+
+// Returns the mode the host last asked for on a port.
+bool USBCompressRequested(uint32_t ui32Port)
+{
+    return(g_psCompressState[ui32Port].bRequested);
+}
+
+//*****************************************************************************
+//
+// Queues data for the host on a port, compressed if the host asked for it.
+//
+// \param ui32Port is the port to send on.
+// \param pui8Data points to the data.
+// \param ui32Size is the number of bytes of data.
+//
+// Uncompressed, the data goes straight into the transmit buffer.  Otherwise
+// it is collected into blocks and each full block coded and moved into the
+// transmit buffer.  A partial block is only sent by USBCompressFlush().  This
+// must be called from the main loop.
+//
+// \return Returns the number of bytes taken, which is less than ui32Size when
+// the transmit buffer is full.  The rest should be offered again after the
+// next USB_EVT_TX_COMPLETE.
+//
+//*****************************************************************************
+uint32_t USBCompressWrite(uint32_t ui32Port, const uint8_t *pui8Data,
+                          uint32_t ui32Size)
+{
+    tUSBCompressState *psState;
+    uint32_t ui32Taken, ui32Chunk;
+
+    if(!ModeUpdate(ui32Port))
+    {
+        return(USBBufferWrite(&g_psTxBuffer[ui32Port], pui8Data, ui32Size));
+    }
+
+    psState = &g_psCompressState[ui32Port];
+    ui32Taken = 0;
+    while((ui32Taken < ui32Size) && !CodedSend(ui32Port))
+    {
+        ui32Chunk = USB_COMPRESS_BLOCK_SIZE - psState->ui32InputSize;
+        if(ui32Chunk > (ui32Size - ui32Taken))
+        {
+            ui32Chunk = ui32Size - ui32Taken;
+        }
+        USBCopy(&psState->pui8Input[psState->ui32InputSize],
+                &pui8Data[ui32Taken], ui32Chunk);
+        psState->ui32InputSize += ui32Chunk;
+        ui32Taken += ui32Chunk;
+
+        if(psState->ui32InputSize == USB_COMPRESS_BLOCK_SIZE)
+        {
+            BlockFinish(ui32Port);
+        }
+    }
+    CodedSend(ui32Port);
+    return(ui32Taken);
+}
+
+// Send the partial block of a port, once the block before it has gone.  Call
+// this when no more data is coming for a while.  Must be called from the main
+// loop.
+void USBCompressFlush(uint32_t ui32Port)
+{
+    if(ModeUpdate(ui32Port))
+    {
+        g_psCompressState[ui32Port].bFlush = true;
+        USBCompressDrain(ui32Port);
+    }
+}
+
+// Move coded data waiting for space into the transmit buffer, followed by the
+// partial block if a flush is pending.  Called from the main loop when the
+// transmit buffer has room again.  Returns true while coded data is still
+// waiting, in which case the port should not be written to.
+bool USBCompressDrain(uint32_t ui32Port)
+{
+    tUSBCompressState *psState;
+
+    psState = &g_psCompressState[ui32Port];
+    if(!ModeUpdate(ui32Port) || CodedSend(ui32Port))
+    {
+        return(psState->ui32CodedSize != 0);
+    }
+
+    if(psState->bFlush && psState->ui32InputSize)
+    {
+        BlockFinish(ui32Port);
+        if(CodedSend(ui32Port))
+        {
+            return(true);
+        }
+    }
+    psState->bFlush = false;
+    return(false);
+}
+
+// The compressing counterpart of USBForward(): move received data to the
+// transmit side of the same port through USBCompressWrite(), and flush once
+// everything received has been taken.  Returns the number of bytes moved.
+uint32_t USBCompressForward(uint32_t ui32Port)
+{
+    tUSBSpan psSpans[2];
+    uint32_t ui32Count, ui32Taken;
+
+    ui32Count = USBRxSpansGet(&g_psRxBuffer[ui32Port], psSpans);
+    ui32Taken = USBCompressWrite(ui32Port, psSpans[0].pui8Data,
+                                 psSpans[0].ui32Size);
+    if((ui32Taken == psSpans[0].ui32Size) && psSpans[1].ui32Size)
+    {
+        ui32Taken += USBCompressWrite(ui32Port, psSpans[1].pui8Data,
+                                      psSpans[1].ui32Size);
+    }
+    USBRxConsume(&g_psRxBuffer[ui32Port], ui32Taken);
+
+    if(ui32Taken == ui32Count)
+    {
+        USBCompressFlush(ui32Port);
+    }
+    return(ui32Taken);
+}
+
+#endif
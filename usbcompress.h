@@ -0,0 +1,59 @@
+/*
+ * usbcompress.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBCOMPRESS_H_
+#define USBCOMPRESS_H_
+
+// Uncomment to let the host switch on compression of the data sent to it
+// with the USB_TELEMETRY_REQ_COMPRESS vendor request.  Data written with
+// USBCompressWrite() is then cut into blocks, each sent LZ4 coded behind a
+// small header.  A port is uncompressed again whenever the device is
+// configured or the host drops DTR, so serial clients that know nothing of
+// this are unaffected.
+//#define USB_COMPRESS
+
+#if defined(USB_COMPRESS) && defined(USB_UART_BRIDGE)
+#error USB_COMPRESS cannot be used with USB_UART_BRIDGE
+#endif
+
+// Bytes of input per block.  Matches are only looked for inside a block,
+// which keeps the hash table to one byte per entry.  At most 256.
+#define USB_COMPRESS_BLOCK_SIZE     256
+
+// log2 of the number of entries in the hash table, which all ports share.
+#define USB_COMPRESS_HASH_BITS      8
+
+// Every block starts with a header of two little-endian 16-bit words: the
+// number of bytes the block decodes to, then the number of bytes that follow
+// the header.  USB_COMPRESS_STORED is set in the second word when the data
+// is stored as-is because coding it would not have made it smaller.
+// Otherwise it is an LZ4 block; offsets never reach past the block start.
+#define USB_COMPRESS_HEADER_SIZE    4
+#define USB_COMPRESS_STORED         0x8000
+
+// Compression counters.  ui32Time is spent coding, in microseconds.
+typedef struct
+{
+    uint32_t ui32RawBytes;
+    uint32_t ui32CodedBytes;        // Headers included.
+    uint32_t ui32Blocks;
+    uint32_t ui32StoredBlocks;
+    uint32_t ui32Time;
+} tUSBCompressStats;
+
+extern tUSBCompressStats g_psUSBCompressStats[USB_PORTS];
+
+void USBCompressRequest(uint32_t ui32Port, bool bEnable);
+void USBCompressReset(uint32_t ui32Port);
+bool USBCompressRequested(uint32_t ui32Port);
+uint32_t USBCompressWrite(uint32_t ui32Port, const uint8_t *pui8Data,
+                          uint32_t ui32Size);
+void USBCompressFlush(uint32_t ui32Port);
+bool USBCompressDrain(uint32_t ui32Port);
+uint32_t USBCompressForward(uint32_t ui32Port);
+
+#endif /* USBCOMPRESS_H_ */
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include "inc/hw_ints.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
 #include "inc/hw_uart.h"
@@ -29,48 +30,800 @@
 #include "usblib/usb-ids.h"
 #include "usblib/device/usbdevice.h"
 #include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
 #include "utils/ustdlib.h"
 #include "usb_structs.h"
 #include "utils/uartstdio.h"
 #include "usbconfig.h"
+#include "usbuart.h"
+#include "usbpower.h"
+#include "usblog.h"
+#include "usbevent.h"
+#include "usbprofile.h"
+#include "usbstack.h"
+#include "usbcompress.h"
+#include "usbtelemetry.h"
+
+// Watermark statistics for the shared buffer arena of each port.
+tUSBBufferStats g_psUSBBufferStats[USB_PORTS];
+
+// Driver state kept for each port.
+typedef struct
+{
+    // Values of the full counters when the arena was last rebalanced.
+    uint32_t ui32RxFullLast;
+    uint32_t ui32TxFullLast;
+
+    // How many ticks the data held back by the latency timer has been
+    // waiting.
+    volatile uint32_t ui32TxAge;
+
+    // Set when the data held back has to be sent without waiting for a full
+    // packet, and while the second half of a packet that wraps the end of
+    // the transmit ring is being written.
+    volatile bool bTxFlush;
+    bool bTxPartial;
+
+    // Set while RxHandler() is reading a burst of packets.
+    bool bRxBurst;
+
+    // The line coding last set by the host, which is what GET_LINE_CODING
+    // reports, and the matching UART configuration word.  In a bridge
+    // bLineCodingPending is set until the UART has been switched over.
+    tLineCoding sLineCoding;
+    uint32_t ui32LineConfig;
+    volatile bool bLineCodingPending;
+} tUSBPortState;
+
+static tUSBPortState g_psPortState[USB_PORTS];
+
+// Latency timer for data to the host, in ticks.  It applies to every port.
+static volatile uint32_t g_ui32TxLatency = USB_TX_LATENCY_DEFAULT;
+
+// Ticks since USBInit(), the SysTick reload period and the number of system
+// clock cycles in a microsecond, for USBTimeSample() and USBTimeToUs().
+static volatile uint32_t g_ui32TickCount;
+static uint32_t g_ui32TickPeriod;
+static uint32_t g_ui32CyclesPerUs;
+
+// Global flag indicating that a USB configuration has been set.
+static volatile bool g_bUSBConfigured;// = false;
+
+// Internal function prototypes.
+static void SetControlLineState(uint32_t ui32Port, uint16_t ui16State);
+static bool SetLineCoding(uint32_t ui32Port, tLineCoding *psLineCoding);
+static void GetLineCoding(uint32_t ui32Port, tLineCoding *psLineCoding);
+#ifdef USB_UART_BRIDGE
+static void LineCodingApply(uint32_t ui32Port);
+#endif
+static void IntPrioritiesSet(void);
+
+// Return the port a CDC instance, as passed to the handlers, belongs to.
+static uint32_t PortFromDevice(void *pvDevice)
+{
+    return((tUSBDCDCDevice *)pvDevice - g_psCDCDevice);
+}
+
+// Give the first ui32RxBlocks blocks of a port's arena to its receive buffer
+// and the rest to its transmit buffer.  Both buffers must be empty.
+static void BufferArenaSplit(uint32_t ui32Port, uint32_t ui32RxBlocks)
+{
+    const tUSBBufferArena *psArena;
+    tUSBBuffer *psRx, *psTx;
+
+    psArena = &g_psUSBBufferArena[ui32Port];
+    psRx = &g_psRxBuffer[ui32Port];
+    psTx = &g_psTxBuffer[ui32Port];
+
+    psRx->pui8Buffer = psArena->pui8Data;
+    psRx->ui32BufferSize = ui32RxBlocks * USB_BUFFER_BLOCK_SIZE;
+    psTx->pui8Buffer = &psArena->pui8Data[psRx->ui32BufferSize];
+    psTx->ui32BufferSize = psArena->ui32Size - psRx->ui32BufferSize;
+
+    USBBufferInit(psTx);
+    USBBufferInit(psRx);
+
+    // Since short packets are held back, a transfer that ends with a full
+    // packet has to be closed with a zero-length packet instead.
+    USBBufferZeroLengthPacketInsert(psTx, true);
+
+    g_psUSBBufferStats[ui32Port].ui32RxBlocks = ui32RxBlocks;
+    g_psUSBBufferStats[ui32Port].ui32TxBlocks =
+        (psArena->ui32Size / USB_BUFFER_BLOCK_SIZE) - ui32RxBlocks;
+}
+
+// Update the buffer watermarks of a port.  Called on every data event.
+static void BufferStatsSample(uint32_t ui32Port)
+{
+    tUSBBufferStats *psStats;
+    uint32_t ui32Used;
+
+    psStats = &g_psUSBBufferStats[ui32Port];
+
+    ui32Used = USBBufferDataAvailable(&g_psRxBuffer[ui32Port]);
+    if(ui32Used > psStats->ui32RxPeak)
+    {
+        psStats->ui32RxPeak = ui32Used;
+    }
+    if(USBBufferSpaceAvailable(&g_psRxBuffer[ui32Port]) < USB_BUFFER_BLOCK_SIZE)
+    {
+        psStats->ui32RxFull++;
+    }
+
+    ui32Used = USBBufferDataAvailable(&g_psTxBuffer[ui32Port]);
+    if(ui32Used > psStats->ui32TxPeak)
+    {
+        psStats->ui32TxPeak = ui32Used;
+    }
+    if(USBBufferSpaceAvailable(&g_psTxBuffer[ui32Port]) < USB_BUFFER_BLOCK_SIZE)
+    {
+        psStats->ui32TxFull++;
+    }
+}
+
+#ifdef USB_DOUBLE_BUFFER
+// Give the bulk data endpoints of a port double-buffered FIFOs.  usblib
+// programs single-packet FIFOs whenever the host sets the configuration, so
+// this has to be repeated on every USB_EVENT_CONNECTED.  The endpoints are
+// idle at that point.
+static void DataFIFOConfigure(uint32_t ui32Port)
+{
+    uint32_t ui32InEP, ui32OutEP, ui32Addr;
+
+    ui32InEP = g_psCDCDevice[ui32Port].sPrivateData.ui8BulkINEndpoint;
+    ui32OutEP = g_psCDCDevice[ui32Port].sPrivateData.ui8BulkOUTEndpoint;
+    ui32Addr = USB_FIFO_DB_ADDR + (ui32Port * 4 * USB_BUFFER_BLOCK_SIZE);
+
+    USBFIFOConfigSet(USB0_BASE, ui32InEP, ui32Addr,
+                     USB_FIFO_SZ_64_DB, USB_EP_DEV_IN);
+    USBFIFOConfigSet(USB0_BASE, ui32OutEP,
+                     ui32Addr + (2 * USB_BUFFER_BLOCK_SIZE),
+                     USB_FIFO_SZ_64_DB, USB_EP_DEV_OUT);
+    USBFIFOFlush(USB0_BASE, ui32InEP, USB_EP_DEV_IN);
+    USBFIFOFlush(USB0_BASE, ui32OutEP, USB_EP_DEV_OUT);
+}
+#endif
 
 // Initialise the USB peripheral
 void USBInit(void)
 {
-	g_ui32Flags = 0;
+	uint32_t ui32Port, ui32Mask;
+
 	g_bUSBConfigured = false;
 
+#ifdef USB_PROFILE
+	USBProfileInit();
+#endif
+
 	ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOD);
 	ROM_GPIOPinTypeUSBAnalog(GPIO_PORTD_BASE, GPIO_PIN_5 | GPIO_PIN_4);
 
-	// Initialize the transmit and receive buffers.
-	USBBufferInit(&TxBuffer);
-	USBBufferInit(&RxBuffer);
+	// Initialize the transmit and receive buffers of every port with its
+	// arena split evenly, and start every port at the default line coding.
+	for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+	{
+		BufferArenaSplit(ui32Port, g_psUSBBufferArena[ui32Port].ui32Size /
+		                 (2 * USB_BUFFER_BLOCK_SIZE));
+
+		g_psPortState[ui32Port].sLineCoding.ui32Rate = USB_UART_DEFAULT_BAUD;
+		g_psPortState[ui32Port].sLineCoding.ui8Stop = USB_CDC_STOP_BITS_1;
+		g_psPortState[ui32Port].sLineCoding.ui8Parity = USB_CDC_PARITY_NONE;
+		g_psPortState[ui32Port].sLineCoding.ui8Databits = 8;
+		g_psPortState[ui32Port].ui32LineConfig = (UART_CONFIG_WLEN_8 |
+		                                          UART_CONFIG_PAR_NONE |
+		                                          UART_CONFIG_STOP_ONE);
+	}
+
+	// Set up the preemption between the driver's interrupts before any of
+	// them is enabled.
+	IntPrioritiesSet();
+#ifdef USB_LATENCY_PROBE
+	USBLatencyInit();
+#endif
+
+	// Start the tick that drives the latency timer.
+	g_ui32TickPeriod = ROM_SysCtlClockGet() / USB_TICK_RATE;
+	g_ui32CyclesPerUs = ROM_SysCtlClockGet() / 1000000;
+	ROM_SysTickPeriodSet(g_ui32TickPeriod);
+	ROM_SysTickIntEnable();
+	ROM_SysTickEnable();
+
+	// Track bus suspend and resume.
+	USBPowerInit();
+
+#ifdef USB_UART_BRIDGE
+	// Bring up the UART on the other side of the bridge.
+	USBUARTInit();
+#endif
 
 	// Set the USB stack mode to Device mode with VBUS monitoring.
 	USBStackModeSet(0, eUSBModeForceDevice, 0);
 
+	// The class driver connects to the bus and enables the USB interrupt
+	// before it returns, but the vendor request handler can only be chained
+	// in once it has filled in its device information.  Hold the interrupt
+	// off until then so that no request is served without it.
+	ui32Mask = USBCriticalEnter();
+
+#if USB_PORTS > 1
+	// Pass our device information to the USB library as one CDC function per
+	// port and place the composite device on the bus.
+	for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+	{
+		USBDCDCCompositeInit(0, &g_psCDCDevice[ui32Port],
+		                     &g_psCompEntries[ui32Port]);
+	}
+	USBDCompositeInit(0, &g_sCompDevice, USB_COMP_DESCRIPTOR_SIZE,
+	                  g_pui8CompDescriptor);
+
+	// Answer vendor requests for the driver counters on endpoint 0.
+	USBTelemetryInit(&g_sCompDevice.sPrivateData.sDevInfo);
+#else
 	// Pass our device information to the USB library and place the device on the bus.
 	USBDCDCInit(0, &g_sCDCDevice);
+
+	// Answer vendor requests for the driver counters on endpoint 0.
+	USBTelemetryInit(&g_sCDCDevice.sPrivateData.sDevInfo);
+#endif
+
+	USBCriticalExit(ui32Mask);
+}
+
+// Describe the data waiting in a receive buffer as up to two spans of ring
+// memory (two only when the data wraps past the end of the ring) so that the
+// application can parse it in place.  Nothing is removed from the buffer
+// until USBRxConsume() is called.  Returns the total number of bytes.
+uint32_t USBRxSpansGet(const tUSBBuffer *psBuffer, tUSBSpan *psSpans)
+{
+    tUSBRingBufObject sRingBuf;
+    uint32_t ui32Used;
+
+    // Take a snapshot of the ring indices.  The read index only moves when
+    // the application consumes data so the spans stay valid until then.
+    USBBufferInfoGet(psBuffer, &sRingBuf);
+    ui32Used = USBRingBufUsed(&sRingBuf);
+
+    psSpans[0].pui8Data = &sRingBuf.pui8Buf[sRingBuf.ui32ReadIndex];
+    psSpans[0].ui32Size = USBRingBufContigUsed(&sRingBuf);
+    psSpans[1].pui8Data = sRingBuf.pui8Buf;
+    psSpans[1].ui32Size = ui32Used - psSpans[0].ui32Size;
+
+    return(ui32Used);
+}
+
+// Release bytes previously returned by USBRxSpansGet() back to the receive
+// buffer, making room for the next packets from the host.
+void USBRxConsume(const tUSBBuffer *psBuffer, uint32_t ui32Count)
+{
+    if(ui32Count)
+    {
+        USBBufferDataRemoved(psBuffer, ui32Count);
+        g_psUSBBufferStats[psBuffer - g_psRxBuffer].ui32RxBytes += ui32Count;
+    }
 }
 
+// Describe the free space in a transmit buffer as up to two spans of ring
+// memory so that the application can build its data in place.  Nothing is
+// sent until the bytes are handed over with USBTxCommit().  Returns the total
+// number of bytes of free space.
+uint32_t USBTxSpansGet(const tUSBBuffer *psBuffer, tUSBSpan *psSpans)
+{
+    tUSBRingBufObject sRingBuf;
+    uint32_t ui32Free;
+
+    // Take a snapshot of the ring indices.  The write index only moves when
+    // the application commits data so the spans stay valid until then.
+    USBBufferInfoGet(psBuffer, &sRingBuf);
+    ui32Free = USBRingBufFree(&sRingBuf);
+
+    psSpans[0].pui8Data = &sRingBuf.pui8Buf[sRingBuf.ui32WriteIndex];
+    psSpans[0].ui32Size = USBRingBufContigFree(&sRingBuf);
+    psSpans[1].pui8Data = sRingBuf.pui8Buf;
+    psSpans[1].ui32Size = ui32Free - psSpans[0].ui32Size;
+
+    return(ui32Free);
+}
+
+// Hand bytes written into the spans returned by USBTxSpansGet() to the
+// transmit buffer and schedule them for transmission to the host.
+void USBTxCommit(const tUSBBuffer *psBuffer, uint32_t ui32Count)
+{
+    if(ui32Count)
+    {
+        USBBufferDataWritten(psBuffer, ui32Count);
+    }
+}
 
-// Set the state of the RS232 RTS and DTR signals.
-static void SetControlLineState(uint16_t ui16State)
+// Drop the first ui32Count bytes from a pair of spans returned by
+// USBRxSpansGet() or USBTxSpansGet().
+void USBSpansSkip(tUSBSpan *psSpans, uint32_t ui32Count)
 {
-    //
-    // TODO: If configured with GPIOs controlling the handshake lines,
-    // set them appropriately depending upon the flags passed in the wValue
-    // field of the request structure passed.
-    //
+    if(ui32Count >= psSpans[0].ui32Size)
+    {
+        ui32Count -= psSpans[0].ui32Size;
+        psSpans[0].pui8Data = &psSpans[1].pui8Data[ui32Count];
+        psSpans[0].ui32Size = psSpans[1].ui32Size - ui32Count;
+        psSpans[1].ui32Size = 0;
+    }
+    else
+    {
+        psSpans[0].pui8Data += ui32Count;
+        psSpans[0].ui32Size -= ui32Count;
+    }
 }
 
-// Set the communication parameters to use on the UART.
-static bool SetLineCoding(tLineCoding *psLineCoding)
+// A 32-bit word at any address.  The Cortex-M4 handles unaligned LDR and STR
+// in hardware, so this compiles to a single load.
+typedef struct __attribute__((packed))
+{
+    uint32_t ui32Word;
+} tUnalignedWord;
+
+// Copy bytes between ring buffers, or between a ring buffer and application
+// memory.  Once the destination is word aligned the bulk of the data is moved
+// 16 bytes at a time with word loads and stores, which the compiler combines
+// into LDM/STM when the source is aligned as well; only the bytes before the
+// first word boundary and after the last one are copied singly.  Callers
+// split their copies at the ring wrap points.
+void USBCopy(uint8_t *pui8Dst, const uint8_t *pui8Src, uint32_t ui32Size)
 {
+    uint32_t *pui32Dst;
+    const uint32_t *pui32Src;
+    const tUnalignedWord *psSrc;
+
+    while(ui32Size && ((uint32_t)pui8Dst & 3))
+    {
+        *pui8Dst++ = *pui8Src++;
+        ui32Size--;
+    }
+
+    pui32Dst = (uint32_t *)pui8Dst;
+    if(!((uint32_t)pui8Src & 3))
+    {
+        pui32Src = (const uint32_t *)pui8Src;
+        while(ui32Size >= 16)
+        {
+            pui32Dst[0] = pui32Src[0];
+            pui32Dst[1] = pui32Src[1];
+            pui32Dst[2] = pui32Src[2];
+            pui32Dst[3] = pui32Src[3];
+            pui32Dst += 4;
+            pui32Src += 4;
+            ui32Size -= 16;
+        }
+        while(ui32Size >= 4)
+        {
+            *pui32Dst++ = *pui32Src++;
+            ui32Size -= 4;
+        }
+        pui8Src = (const uint8_t *)pui32Src;
+    }
+    else
+    {
+        psSrc = (const tUnalignedWord *)pui8Src;
+        while(ui32Size >= 16)
+        {
+            pui32Dst[0] = psSrc[0].ui32Word;
+            pui32Dst[1] = psSrc[1].ui32Word;
+            pui32Dst[2] = psSrc[2].ui32Word;
+            pui32Dst[3] = psSrc[3].ui32Word;
+            pui32Dst += 4;
+            psSrc += 4;
+            ui32Size -= 16;
+        }
+        while(ui32Size >= 4)
+        {
+            *pui32Dst++ = (psSrc++)->ui32Word;
+            ui32Size -= 4;
+        }
+        pui8Src = (const uint8_t *)psSrc;
+    }
+    pui8Dst = (uint8_t *)pui32Dst;
+
+    while(ui32Size--)
+    {
+        *pui8Dst++ = *pui8Src++;
+    }
+}
+
+// Copy ui32Count bytes from one pair of spans to another, splitting the copy
+// wherever either side wraps.
+static void SpansCopy(const tUSBSpan *psDst, const tUSBSpan *psSrc,
+                      uint32_t ui32Count)
+{
+    uint32_t ui32Dst, ui32DstOffset, ui32Src, ui32SrcOffset, ui32Chunk;
+
+    ui32Dst = ui32DstOffset = ui32Src = ui32SrcOffset = 0;
+    while(ui32Count)
+    {
+        ui32Chunk = ui32Count;
+        if(ui32Chunk > (psSrc[ui32Src].ui32Size - ui32SrcOffset))
+        {
+            ui32Chunk = psSrc[ui32Src].ui32Size - ui32SrcOffset;
+        }
+        if(ui32Chunk > (psDst[ui32Dst].ui32Size - ui32DstOffset))
+        {
+            ui32Chunk = psDst[ui32Dst].ui32Size - ui32DstOffset;
+        }
+
+        USBCopy(&psDst[ui32Dst].pui8Data[ui32DstOffset],
+                &psSrc[ui32Src].pui8Data[ui32SrcOffset], ui32Chunk);
+        ui32Count -= ui32Chunk;
+
+        ui32SrcOffset += ui32Chunk;
+        if(ui32SrcOffset == psSrc[ui32Src].ui32Size)
+        {
+            ui32Src++;
+            ui32SrcOffset = 0;
+        }
+        ui32DstOffset += ui32Chunk;
+        if(ui32DstOffset == psDst[ui32Dst].ui32Size)
+        {
+            ui32Dst++;
+            ui32DstOffset = 0;
+        }
+    }
+}
+
+// Move as much data from a receive buffer to a transmit buffer as the
+// transmit buffer can currently accept.  The data is copied straight from one
+// ring to the other.  Anything that does not fit is left queued in the
+// receive buffer; once that fills up the OUT endpoint NAKs the host until
+// TxHandler() sees the next USB_EVENT_TX_COMPLETE and gives the application
+// another chance to forward it.  Returns the bytes moved.
+uint32_t USBForward(const tUSBBuffer *psRxBuffer, const tUSBBuffer *psTxBuffer)
+{
+    tUSBSpan psRxSpans[2], psTxSpans[2];
+    uint32_t ui32Count, ui32Space;
+    USB_PROBE_START();
+
+    ui32Count = USBRxSpansGet(psRxBuffer, psRxSpans);
+    ui32Space = USBTxSpansGet(psTxBuffer, psTxSpans);
+    if(ui32Count > ui32Space)
+    {
+        ui32Count = ui32Space;
+    }
+
+    SpansCopy(psTxSpans, psRxSpans, ui32Count);
+
+#ifdef USB_PROFILE
+    // Record the copy time scaled to one full packet.
+    if(ui32Count)
+    {
+        USBProfileRecord(USB_PROBE_FORWARD,
+                         ((USB_PROFILE_TIMESTAMP() - ui32ProbeStart) *
+                          USB_BUFFER_BLOCK_SIZE) / ui32Count);
+    }
+#endif
+
+    USBTxCommit(psTxBuffer, ui32Count);
+    USBRxConsume(psRxBuffer, ui32Count);
+    return(ui32Count);
+}
+
+//*****************************************************************************
+//
+// Hands a packet from the transmit buffer to the CDC driver.
+//
+// \param pvHandle is the CDC device instance.
+// \param pui8Data points to the data to send.
+// \param ui32Size is the number of bytes to send.
+// \param bLast is true if this completes the packet.
+//
+// This sits between the transmit buffer and USBDCDCPacketWrite() and
+// implements the latency timer.  A full packet is always sent, but a short
+// one is refused until the timer has expired or USBTxFlush() has been
+// called, so that small writes are coalesced into full packets.  The buffer
+// tries again when more data is written or the tick handler kicks it.  When
+// the data wraps the end of the ring the buffer writes the packet in two
+// parts and the decision made for the first part also covers the second.
+//
+// \return Returns the number of bytes accepted.
+//
+//*****************************************************************************
+uint32_t TxPacketWrite(void *pvHandle, uint8_t *pui8Data, uint32_t ui32Size,
+                       bool bLast)
+{
+    uint32_t ui32Port, ui32Queued;
+    tUSBPortState *psState;
+
+    ui32Port = PortFromDevice(pvHandle);
+    psState = &g_psPortState[ui32Port];
+
+    // Zero-length packets and the second part of a packet always go.
+    if(ui32Size && !psState->bTxPartial)
+    {
+        ui32Queued = USBBufferDataAvailable(&g_psTxBuffer[ui32Port]);
+        if(ui32Queued < USB_BUFFER_BLOCK_SIZE)
+        {
+            if(g_ui32TxLatency && !psState->bTxFlush)
+            {
+                return(0);
+            }
+
+            // This short packet empties the buffer, which ends the flush.
+            psState->bTxFlush = false;
+        }
+        psState->ui32TxAge = 0;
+        USBPowerDataMoved();
+    }
+
+    psState->bTxPartial = !bLast;
+    return(USBDCDCPacketWrite(pvHandle, pui8Data, ui32Size, bLast));
+}
+
+// Send whatever is in a transmit buffer without waiting for the latency
+// timer.
+void USBTxFlush(const tUSBBuffer *psBuffer)
+{
+    g_psPortState[psBuffer - g_psTxBuffer].bTxFlush = true;
+    USBBufferDataWritten(psBuffer, 0);
+}
+
+// Set the latency timer in milliseconds.  Zero sends every write to the host
+// straight away, larger values trade latency for fuller packets.
+void USBTxLatencySet(uint32_t ui32Ms)
+{
+    uint32_t ui32Port;
+
+    g_ui32TxLatency = (ui32Ms * USB_TICK_RATE) / 1000;
+    if(!g_ui32TxLatency)
+    {
+        for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+        {
+            USBTxFlush(&g_psTxBuffer[ui32Port]);
+        }
+    }
+}
+
+// Return the latency timer in milliseconds.
+uint32_t USBTxLatencyGet(void)
+{
+    return((g_ui32TxLatency * 1000) / USB_TICK_RATE);
+}
+
+// SysTick interrupt handler.  Runs the latency timer of each port: once data
+// has been held back for the full latency it is flushed to the host.  In a
+// bridge it also finishes line coding changes once the UART has drained.
+// SysTick runs at the same priority as the USB interrupt and so cannot
+// preempt it.
+void USBTickHandler(void)
+{
+    tUSBPortState *psState;
+    uint32_t ui32Port;
+
+#ifdef USB_LATENCY_PROBE
+    // The counter started down from the reload value when the tick was due.
+    USBLatencyRecord(&g_sUSBLatencyStats.ui32Tick,
+                     g_ui32TickPeriod - 1 - ROM_SysTickValueGet());
+#endif
+    USBStackSample();
+    g_ui32TickCount++;
+
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        psState = &g_psPortState[ui32Port];
+#ifdef USB_UART_BRIDGE
+        if(psState->bLineCodingPending)
+        {
+            LineCodingApply(ui32Port);
+        }
+#endif
+        if(g_ui32TxLatency && !psState->bTxFlush &&
+           USBBufferDataAvailable(&g_psTxBuffer[ui32Port]))
+        {
+            if(++psState->ui32TxAge >= g_ui32TxLatency)
+            {
+                USBTxFlush(&g_psTxBuffer[ui32Port]);
+            }
+        }
+    }
+}
+
+// Read the tick count and the SysTick down counter as one consistent pair,
+// for USBTimeToUs() to turn into a time later.  This is all a timestamp costs
+// where it is taken, and may be called from any context.
+void USBTimeSample(uint32_t *pui32Ticks, uint32_t *pui32Count)
+{
+    uint32_t ui32Ticks, ui32Count;
+    bool bWrapped;
+
+    do
+    {
+        ui32Ticks = g_ui32TickCount;
+        ui32Count = ROM_SysTickValueGet();
+
+        // When called from an interrupt that SysTick cannot preempt, the
+        // counter may have wrapped without the tick having been taken yet.
+        bWrapped = (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PEND_STSET) ? true :
+                   false;
+        if(bWrapped)
+        {
+            ui32Count = ROM_SysTickValueGet();
+        }
+    }
+    while(ui32Ticks != g_ui32TickCount);
+
+    if(bWrapped)
+    {
+        ui32Ticks++;
+    }
+
+    *pui32Ticks = ui32Ticks;
+    *pui32Count = ui32Count;
+}
+
+// Convert a pair read by USBTimeSample() to microseconds.
+uint32_t USBTimeToUs(uint32_t ui32Ticks, uint32_t ui32Count)
+{
+    return((ui32Ticks * (1000000 / USB_TICK_RATE)) +
+           ((g_ui32TickPeriod - 1 - ui32Count) / g_ui32CyclesPerUs));
+}
+
+// Return the time in microseconds from the tick count and the SysTick down
+// counter.  It wraps after about 71 minutes and stands still while SysTick is
+// stopped, so with USB_POWER_SAVE it leaves out the time spent asleep in a
+// bus suspend: intervals that span a sleep, such as between log records, come
+// out short by that much.  This may be called from any context.
+uint32_t USBTimeGet(void)
+{
+    uint32_t ui32Ticks, ui32Count;
+
+    USBTimeSample(&ui32Ticks, &ui32Count);
+    return(USBTimeToUs(ui32Ticks, ui32Count));
+}
+
+// Keep every interrupt the driver uses out until USBCriticalExit() is called
+// with the value returned.  Only BASEPRI is raised, so nothing of a higher
+// priority than USB_INT_PRIORITY_UART is held up, and sections nest.  This
+// may be called from any context.
+uint32_t USBCriticalEnter(void)
+{
+    uint32_t ui32Mask;
+
+    ui32Mask = IntPriorityMaskGet();
+    if(!ui32Mask || (ui32Mask > USB_INT_PRIORITY_UART))
+    {
+        IntPriorityMaskSet(USB_INT_PRIORITY_UART);
+    }
+    return(ui32Mask);
+}
+
+void USBCriticalExit(uint32_t ui32Mask)
+{
+    IntPriorityMaskSet(ui32Mask);
+}
+
+// Give every interrupt the driver uses its priority from usbconfig.h.
+static void IntPrioritiesSet(void)
+{
+#ifdef USB_UART_BRIDGE
+    uint32_t ui32Port;
+
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        ROM_IntPrioritySet(g_psUSBUARTPorts[ui32Port].ui32Int,
+                           USB_INT_PRIORITY_UART);
+#ifdef USB_UART_FLOW_CONTROL
+        ROM_IntPrioritySet(g_psUSBUARTPorts[ui32Port].ui32FlowInt,
+                           USB_INT_PRIORITY_UART);
+#endif
+    }
+#endif
+
+    ROM_IntPrioritySet(INT_USB0, USB_INT_PRIORITY_USB);
+    ROM_IntPrioritySet(FAULT_SYSTICK, USB_INT_PRIORITY_USB);
+    ROM_IntPrioritySet(FAULT_PENDSV, USB_INT_PRIORITY_USB);
+
+#ifdef USB_LATENCY_PROBE
+    ROM_IntPrioritySet(INT_TIMER0A, USB_INT_PRIORITY_USB);
+    ROM_IntPrioritySet(INT_TIMER1A, USB_INT_PRIORITY_UART);
+#endif
+}
+
+// Work out the new arena split of a port from the pressure on each buffer
+// and apply it.  Both buffers are empty and the interrupts using them are
+// held off.
+static bool BufferArenaRebalance(uint32_t ui32Port)
+{
+    tUSBBufferStats *psStats;
+    tUSBPortState *psState;
+    uint32_t ui32RxPressure, ui32TxPressure, ui32RxBlocks, ui32Blocks;
+
+    psStats = &g_psUSBBufferStats[ui32Port];
+    psState = &g_psPortState[ui32Port];
+
+    ui32RxPressure = psStats->ui32RxFull - psState->ui32RxFullLast;
+    ui32TxPressure = psStats->ui32TxFull - psState->ui32TxFullLast;
+    psState->ui32RxFullLast = psStats->ui32RxFull;
+    psState->ui32TxFullLast = psStats->ui32TxFull;
+
+    ui32Blocks = g_psUSBBufferArena[ui32Port].ui32Size / USB_BUFFER_BLOCK_SIZE;
+    ui32RxBlocks = psStats->ui32RxBlocks;
+    if((ui32RxPressure > ui32TxPressure) &&
+       (ui32RxBlocks < (ui32Blocks - USB_BUFFER_MIN_BLOCKS)))
+    {
+        ui32RxBlocks++;
+    }
+    else if((ui32TxPressure > ui32RxPressure) &&
+            (ui32RxBlocks > USB_BUFFER_MIN_BLOCKS))
+    {
+        ui32RxBlocks--;
+    }
+    else
+    {
+        return(false);
+    }
+
+    BufferArenaSplit(ui32Port, ui32RxBlocks);
+    psStats->ui32Rebalances++;
+    USB_LOG(USB_LOG_REBALANCE, ui32Port, ui32RxBlocks);
+    return(true);
+}
+
+// Lend one block of a port's buffer arena to whichever direction has run out
+// of space more often since the last call.  The ring geometry can only change
+// while both buffers are empty so nothing is done otherwise.  Returns true
+// if the split was moved.  This must be called from the main loop.
+bool USBBufferRebalance(uint32_t ui32Port)
+{
+    uint32_t ui32Mask;
+    bool bMoved;
+
+    // Keep the interrupts that use the buffers out while they may be
+    // reinitialised.  In a bridge the UART may also have written data for
+    // the host that the transmit buffer does not know about yet.
+    ui32Mask = USBCriticalEnter();
+
+    bMoved = false;
+    if(!USBBufferDataAvailable(&g_psRxBuffer[ui32Port]) &&
+       !USBBufferDataAvailable(&g_psTxBuffer[ui32Port])
+#ifdef USB_UART_BRIDGE
+       && !USBUARTRxStaged(ui32Port)
+#endif
+       )
+    {
+        bMoved = BufferArenaRebalance(ui32Port);
+    }
+
+    USBCriticalExit(ui32Mask);
+
+    return(bMoved);
+}
+
+// Set the state of the RS232 RTS and DTR signals of a port.
+static void SetControlLineState(uint32_t ui32Port, uint16_t ui16State)
+{
+#ifdef USB_UART_BRIDGE
+    // Pass them on to the handshake pins of the bridge, if it has any.
+    USBUARTControlLineSet(ui32Port, ui16State);
+#endif
+
+#ifdef USB_COMPRESS
+    // The client that asked for compression has closed the port.
+    if(!(ui16State & USB_CDC_DTE_PRESENT))
+    {
+        USBCompressReset(ui32Port);
+    }
+#endif
+}
+
+// Set the communication parameters to use on a port.  They are kept as the
+// port's line coding, with any value we cannot support replaced by the one
+// actually used.  In a bridge the data the host sent before the change still
+// goes out with the old parameters: the UART is only reconfigured by
+// LineCodingApply() once that data has drained, and the data sent after the
+// change waits for it.
+static bool SetLineCoding(uint32_t ui32Port, tLineCoding *psLineCoding)
+{
+    tUSBPortState *psState;
     uint32_t ui32Config;
     bool bRetcode;
 
+    psState = &g_psPortState[ui32Port];
+    psState->sLineCoding = *psLineCoding;
+    psLineCoding = &psState->sLineCoding;
+
     // Assume everything is OK until we detect any problem.
     bRetcode = true;
 
@@ -101,6 +854,7 @@ static bool SetLineCoding(tLineCoding *psLineCoding)
         default:
         {
             ui32Config = UART_CONFIG_WLEN_8;
+            psLineCoding->ui8Databits = 8;
             bRetcode = false;
             break;
         }
@@ -137,6 +891,7 @@ static bool SetLineCoding(tLineCoding *psLineCoding)
         default:
         {
             ui32Config |= UART_CONFIG_PAR_NONE;
+            psLineCoding->ui8Parity = USB_CDC_PARITY_NONE;
             bRetcode = false;
             break;
         }
@@ -166,98 +921,56 @@ static bool SetLineCoding(tLineCoding *psLineCoding)
         default:
         {
             ui32Config |= UART_CONFIG_STOP_ONE;
+            psLineCoding->ui8Stop = USB_CDC_STOP_BITS_1;
             bRetcode = false;
             break;
         }
     }
+    psState->ui32LineConfig = ui32Config;
+    USB_LOG(USB_LOG_LINE_CODING, ui32Port, psLineCoding->ui32Rate);
+
+#ifdef USB_UART_BRIDGE
+    // Hold back whatever the host sends next and switch the UART over as soon
+    // as the data already queued has gone, which may be straight away.
+    USBUARTTxHold(ui32Port);
+    psState->bLineCodingPending = true;
+    LineCodingApply(ui32Port);
+#else
+    USBEventPost(ui32Port, USB_EVT_LINE_CODING);
+#endif
+
     // Let the caller know if we had a problem or not.
     return(bRetcode);
 }
 
-// Get the communication parameters in use on the UART.
-static void GetLineCoding(tLineCoding *psLineCoding)
+#ifdef USB_UART_BRIDGE
+// Apply a port's pending line coding to its UART if nothing sent under the
+// old one is left to transmit.  This uses the same test as the answer to
+// USB_EVENT_DATA_REMAINING.  Called when the coding is set and then from
+// every tick until it succeeds.
+static void LineCodingApply(uint32_t ui32Port)
 {
-    uint32_t ui32Config;
-    uint32_t ui32Rate;
-
-    // Get the current line coding set in the UART.
-    ROM_UARTConfigGetExpClk(USB_UART_BASE, ROM_SysCtlClockGet(), &ui32Rate,
-                            &ui32Config);
-    psLineCoding->ui32Rate = ui32Rate;
-
-    // Translate the configuration word length field into the format expected
-    // by the host.
-    switch(ui32Config & UART_CONFIG_WLEN_MASK)
-    {
-        case UART_CONFIG_WLEN_8:
-        {
-            psLineCoding->ui8Databits = 8;
-            break;
-        }
-        case UART_CONFIG_WLEN_7:
-        {
-            psLineCoding->ui8Databits = 7;
-            break;
-        }
-        case UART_CONFIG_WLEN_6:
-        {
-            psLineCoding->ui8Databits = 6;
-            break;
-        }
-        case UART_CONFIG_WLEN_5:
-        {
-            psLineCoding->ui8Databits = 5;
-            break;
-        }
-    }
+    tUSBPortState *psState;
 
-    // Translate the configuration parity field into the format expected
-    // by the host.
-    switch(ui32Config & UART_CONFIG_PAR_MASK)
+    if(USBUARTTxRemaining(ui32Port))
     {
-        case UART_CONFIG_PAR_NONE:
-        {
-            psLineCoding->ui8Parity = USB_CDC_PARITY_NONE;
-            break;
-        }
-        case UART_CONFIG_PAR_ODD:
-        {
-            psLineCoding->ui8Parity = USB_CDC_PARITY_ODD;
-            break;
-        }
-        case UART_CONFIG_PAR_EVEN:
-        {
-            psLineCoding->ui8Parity = USB_CDC_PARITY_EVEN;
-            break;
-        }
-        case UART_CONFIG_PAR_ONE:
-        {
-            psLineCoding->ui8Parity = USB_CDC_PARITY_MARK;
-            break;
-        }
-        case UART_CONFIG_PAR_ZERO:
-        {
-            psLineCoding->ui8Parity = USB_CDC_PARITY_SPACE;
-            break;
-        }
+        return;
     }
 
-    // Translate the configuration stop bits field into the format expected
-    // by the host.
-    switch(ui32Config & UART_CONFIG_STOP_MASK)
-    {
-        case UART_CONFIG_STOP_ONE:
-        {
-            psLineCoding->ui8Stop = USB_CDC_STOP_BITS_1;
-            break;
-        }
+    psState = &g_psPortState[ui32Port];
+    psState->bLineCodingPending = false;
+    USBUARTConfigure(ui32Port, psState->sLineCoding.ui32Rate,
+                     psState->ui32LineConfig);
+    USBEventPost(ui32Port, USB_EVT_LINE_CODING);
+}
+#endif
 
-        case UART_CONFIG_STOP_TWO:
-        {
-            psLineCoding->ui8Stop = USB_CDC_STOP_BITS_2;
-            break;
-        }
-    }
+// Get the communication parameters of a port.  These are the ones the host
+// last set, even while a bridge is still draining data sent with the old
+// ones.
+static void GetLineCoding(uint32_t ui32Port, tLineCoding *psLineCoding)
+{
+    *psLineCoding = g_psPortState[ui32Port].sLineCoding;
 }
 
 //*****************************************************************************
@@ -272,7 +985,8 @@ static void GetLineCoding(tLineCoding *psLineCoding)
 // This function is called by the CDC driver to perform control-related
 // operations on behalf of the USB host.  These functions include setting
 // and querying the serial communication parameters, setting handshake line
-// states and sending break conditions.
+// states and sending break conditions.  The callback pointer is the CDC
+// instance of the port concerned.
 //
 // \return The return value is event-specific.
 //
@@ -280,7 +994,11 @@ static void GetLineCoding(tLineCoding *psLineCoding)
 uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
                uint32_t ui32MsgValue, void *pvMsgData)
 {
-    uint32_t ui32IntsOff;
+    uint32_t ui32Port, ui32Mask;
+    USB_PROBE_START();
+
+    USBStackSample();
+    ui32Port = PortFromDevice(pvCBData);
 
     // Which event are we being asked to process?
     switch(ui32Event)
@@ -289,41 +1007,43 @@ uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
         case USB_EVENT_CONNECTED:
             g_bUSBConfigured = true;
 
-            // Flush our buffers.
-            USBBufferFlush(&TxBuffer);
-            USBBufferFlush(&RxBuffer);
+#ifdef USB_DOUBLE_BUFFER
+            // Switch the data endpoints over to double buffering.
+            DataFIFOConfigure(ui32Port);
+#endif
 
-            // Tell the main loop to update the display.
-            ui32IntsOff = ROM_IntMasterDisable();
-            g_pcStatus = "Connected";
-            g_ui32Flags |= COMMAND_STATUS_UPDATE;
-            if(!ui32IntsOff)
-            {
-                ROM_IntMasterEnable();
-            }
+            // Flush our buffers, along with anything the UART interrupt has
+            // taken from or added to them.
+            ui32Mask = USBCriticalEnter();
+            USBBufferFlush(&g_psTxBuffer[ui32Port]);
+            USBBufferFlush(&g_psRxBuffer[ui32Port]);
+#ifdef USB_UART_BRIDGE
+            USBUARTFlush(ui32Port);
+#endif
+            USBCriticalExit(ui32Mask);
+#ifdef USB_COMPRESS
+            USBCompressReset(ui32Port);
+#endif
+
+            // Tell the main loop.
+            USBEventPost(ui32Port, USB_EVT_CONNECTED);
             break;
         // The host has disconnected.
         case USB_EVENT_DISCONNECTED:
             g_bUSBConfigured = false;
-            ui32IntsOff = ROM_IntMasterDisable();
-            g_pcStatus = "Disconnected";
-            g_ui32Flags |= COMMAND_STATUS_UPDATE;
-            if(!ui32IntsOff)
-            {
-                ROM_IntMasterEnable();
-            }
+            USBEventPost(ui32Port, USB_EVT_DISCONNECTED);
             break;
         // Return the current serial communication parameters.
         case USBD_CDC_EVENT_GET_LINE_CODING:
-            GetLineCoding(pvMsgData);
+            GetLineCoding(ui32Port, pvMsgData);
             break;
         // Set the current serial communication parameters.
         case USBD_CDC_EVENT_SET_LINE_CODING:
-            SetLineCoding(pvMsgData);
+            SetLineCoding(ui32Port, pvMsgData);
             break;
         // Set the current serial communication parameters.
         case USBD_CDC_EVENT_SET_CONTROL_LINE_STATE:
-            SetControlLineState((uint16_t)ui32MsgValue);
+            SetControlLineState(ui32Port, (uint16_t)ui32MsgValue);
             break;
         // Send a break condition on the serial line.
         case USBD_CDC_EVENT_SEND_BREAK:
@@ -331,9 +1051,15 @@ uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
         // Clear the break condition on the serial line.
         case USBD_CDC_EVENT_CLEAR_BREAK:
             break;
-        // Ignore SUSPEND and RESUME for now.
+        // Let the main loop sleep through a bus suspend, then pass both on to
+        // it.
         case USB_EVENT_SUSPEND:
+            USBPowerSuspend();
+            USBEventPost(ui32Port, USB_EVT_SUSPEND);
+            break;
         case USB_EVENT_RESUME:
+            USBPowerResume();
+            USBEventPost(ui32Port, USB_EVT_RESUME);
             break;
         // We don't expect to receive any other events.  Ignore any that show
         // up in a release build or hang in a debug build.
@@ -344,6 +1070,7 @@ uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
             break;
 #endif
     }
+    USB_PROBE_END(USB_PROBE_CONTROL_HANDLER);
     return(0);
 }
 
@@ -367,12 +1094,24 @@ uint32_t ControlHandler(void *pvCBData, uint32_t ui32Event,
 uint32_t TxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
           void *pvMsgData)
 {
+    uint32_t ui32Port;
+    USB_PROBE_START();
+
+    USBStackSample();
+    ui32Port = PortFromDevice(pvCBData);
+
     // Which event have we been sent?
     switch(ui32Event)
     {
         case USB_EVENT_TX_COMPLETE:
-            // Since we are using the USBBuffer, we don't need to do anything
-            // here.
+            // Space has been freed in the transmit buffer.  Let the main loop
+            // decide what to do with it.
+            BufferStatsSample(ui32Port);
+#ifdef USB_UART_BRIDGE
+            // Let the peer send again if enough of the buffer has drained.
+            USBUARTFlowUpdate(ui32Port);
+#endif
+            USBEventPost(ui32Port, USB_EVT_TX_COMPLETE);
             break;
         // We don't expect to receive any other events.  Ignore any that show
         // up in a release build or hang in a debug build.
@@ -383,9 +1122,62 @@ uint32_t TxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
             break;
 #endif
     }
+    USB_PROBE_END(USB_PROBE_TX_HANDLER);
     return(0);
 }
 
+// Read the packets waiting in a port's OUT endpoint FIFO behind the one that
+// raised USB_EVENT_RX_AVAILABLE, within the burst budget.  Each is read by the
+// receive buffer as if its own interrupt had arrived; the nested calls to
+// RxHandler() see bRxBurst and leave the batch to the outer one.  Packets
+// that do not fit in the buffer stay in the FIFO.
+static void RxBurst(uint32_t ui32Port)
+{
+    tUSBBufferStats *psStats;
+    uint32_t ui32Size, ui32Bytes, ui32Start;
+
+    psStats = &g_psUSBBufferStats[ui32Port];
+    psStats->ui32RxBursts++;
+    psStats->ui32RxPackets++;
+
+    g_psPortState[ui32Port].bRxBurst = true;
+    ui32Start = USBTimeGet();
+    ui32Bytes = 0;
+    while(ui32Bytes < USB_RX_BURST_BYTES)
+    {
+        ui32Size = USBDCDCRxPacketAvailable(&g_psCDCDevice[ui32Port]);
+        if(!ui32Size ||
+           (USBBufferSpaceAvailable(&g_psRxBuffer[ui32Port]) < ui32Size) ||
+           ((USBTimeGet() - ui32Start) >= USB_RX_BURST_US))
+        {
+            break;
+        }
+
+        USBBufferEventCallback((void *)&g_psRxBuffer[ui32Port],
+                               USB_EVENT_RX_AVAILABLE, ui32Size, 0);
+        ui32Bytes += ui32Size;
+        psStats->ui32RxPackets++;
+    }
+    g_psPortState[ui32Port].bRxBurst = false;
+}
+
+// Take in the packet left in a port's OUT endpoint FIFO while the receive
+// buffer was too full for it, now that room has been made.  Otherwise it
+// waits for the CDC driver to offer it again on the next frame.  This must
+// be called at the priority of the USB interrupt.
+void USBRxResume(uint32_t ui32Port)
+{
+    uint32_t ui32Size;
+
+    ui32Size = USBDCDCRxPacketAvailable(&g_psCDCDevice[ui32Port]);
+    if(ui32Size &&
+       (USBBufferSpaceAvailable(&g_psRxBuffer[ui32Port]) >= ui32Size))
+    {
+        USBBufferEventCallback((void *)&g_psRxBuffer[ui32Port],
+                               USB_EVENT_RX_AVAILABLE, ui32Size, 0);
+    }
+}
+
 //*****************************************************************************
 //
 // Handles CDC driver notifications related to the receive channel (data from
@@ -406,16 +1198,37 @@ uint32_t TxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
 uint32_t RxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
           void *pvMsgData)
 {
-    uint32_t ui32Count;
+    uint32_t ui32Port, ui32Count;
+    USB_PROBE_START();
+
+    USBStackSample();
+    ui32Port = PortFromDevice(pvCBData);
+    ui32Count = 0;
 
     // Which event are we being sent?
     switch(ui32Event)
     {
-        // A new packet has been received.
+        // A new packet has been received.  Pull in any others already
+        // waiting and deal with them all at once.
         case USB_EVENT_RX_AVAILABLE:
         {
-            // Call the user defined RX data handler
-        	RxDataHandler();
+            if(g_psPortState[ui32Port].bRxBurst)
+            {
+                break;
+            }
+            RxBurst(ui32Port);
+
+            BufferStatsSample(ui32Port);
+            USBPowerDataMoved();
+
+#ifdef USB_UART_BRIDGE
+            // Feed the new data to the UART.
+            USBUARTTxPump(ui32Port);
+#else
+            // Have the main loop call the user defined RX data handler.  No
+            // application code runs in interrupt context.
+            USBEventPost(ui32Port, USB_EVT_RX_AVAILABLE);
+#endif
             break;
         }
         // We are being asked how much unprocessed data we have still to
@@ -427,8 +1240,13 @@ uint32_t RxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
         {
             // Get the number of bytes in the buffer and add 1 if some data
             // still has to clear the transmitter.
-            ui32Count = ROM_UARTBusy(USB_UART_BASE) ? 1 : 0;
-            return(ui32Count);
+#ifdef USB_UART_BRIDGE
+            ui32Count = USBUARTTxRemaining(ui32Port);
+#else
+            ui32Count = USBBufferDataAvailable(&g_psRxBuffer[ui32Port]);
+            ui32Count += ROM_UARTBusy(USB_UART_BASE) ? 1 : 0;
+#endif
+            break;
         }
         // We are being asked to provide a buffer into which the next packet
         // can be read. We do not support this mode of receiving data so let
@@ -437,7 +1255,7 @@ uint32_t RxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
         // completeness.
         case USB_EVENT_REQUEST_BUFFER:
         {
-            return(0);
+            break;
         }
         // We don't expect to receive any other events.  Ignore any that show
         // up in a release build or hang in a debug build.
@@ -448,5 +1266,6 @@ uint32_t RxHandler(void *pvCBData, uint32_t ui32Event, uint32_t ui32MsgValue,
             break;
 #endif
     }
-    return(0);
+    USB_PROBE_END(USB_PROBE_RX_HANDLER);
+    return(ui32Count);
 }
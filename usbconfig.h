@@ -8,26 +8,172 @@
 #ifndef USBCONFIG_H_
 #define USBCONFIG_H_
 
-// Defines required to redirect UART0 via USB.
+// Defines required to redirect UART0 via USB.  These are for the first port;
+// the USB_PORTn_UART_ defines below give the UARTs of the other ports when
+// USB_PORTS in usb_structs.h is raised.
 #define USB_UART_BASE           UART0_BASE
 #define USB_UART_PERIPH         SYSCTL_PERIPH_UART0
 #define USB_UART_INT            INT_UART0
+#define USB_UART_GPIO_PERIPH    SYSCTL_PERIPH_GPIOA
+#define USB_UART_GPIO_BASE      GPIO_PORTA_BASE
+#define USB_UART_GPIO_PINS      (GPIO_PIN_0 | GPIO_PIN_1)
+#define USB_UART_RX_PIN         GPIO_PA0_U0RX
+#define USB_UART_TX_PIN         GPIO_PA1_U0TX
+#define USB_UART_DEFAULT_BAUD   115200
 
-// Flags used to pass commands from interrupt context to the main loop.
-#define COMMAND_PACKET_RECEIVED 0x00000001
-#define COMMAND_STATUS_UPDATE   0x00000002
+// Uncomment to bridge the CDC data channel to USB_UART_BASE instead of
+// passing received data to RxDataHandler().  The UART is then owned by the
+// bridge and can no longer be used for the uartstdio console.
+//#define USB_UART_BRIDGE
 
-volatile uint32_t g_ui32Flags;
-char *g_pcStatus;
+// Uncomment to have the bridge feed the UART TX FIFO from the USB receive
+// buffer with the uDMA controller instead of the CPU.
+//#define USB_UART_UDMA
+#define USB_UART_UDMA_TX        UDMA_CHANNEL_UART0TX
+#define USB_UART_UDMA_TX_MAP    UDMA_CH9_UART0TX
 
-// Global flag indicating that a USB configuration has been set.
-static volatile bool g_bUSBConfigured;// = false;
+// Uncomment to add RTS/CTS hardware flow control and a DTR output to the
+// bridge on the GPIOs below.  The lines are active low, as at the UART pins
+// of an RS232 transceiver.  RTS is dropped when fewer than
+// USB_UART_FLOW_HEADROOM bytes are free in the buffer to the host and raised
+// again once it is half empty; the headroom covers the UART RX FIFO and the
+// characters a peer sends before it reacts.
+//#define USB_UART_FLOW_CONTROL
+#define USB_UART_FLOW_PERIPH    SYSCTL_PERIPH_GPIOE
+#define USB_UART_FLOW_BASE      GPIO_PORTE_BASE
+#define USB_UART_FLOW_INT       INT_GPIOE
+#define USB_UART_RTS_PIN        GPIO_PIN_1
+#define USB_UART_CTS_PIN        GPIO_PIN_2
+#define USB_UART_DTR_PIN        GPIO_PIN_3
+#define USB_UART_FLOW_HEADROOM  48
 
-// Internal function prototypes.
-static void SetControlLineState(uint16_t ui16State);
-static bool SetLineCoding(tLineCoding *psLineCoding);
-static void GetLineCoding(tLineCoding *psLineCoding);
+// UART1 on PB0/PB1 for the second port, with its handshake lines on
+// PD2 (RTS), PD3 (CTS) and PD6 (DTR).
+#define USB_PORT1_UART_BASE         UART1_BASE
+#define USB_PORT1_UART_PERIPH       SYSCTL_PERIPH_UART1
+#define USB_PORT1_UART_INT          INT_UART1
+#define USB_PORT1_UART_GPIO_PERIPH  SYSCTL_PERIPH_GPIOB
+#define USB_PORT1_UART_GPIO_BASE    GPIO_PORTB_BASE
+#define USB_PORT1_UART_GPIO_PINS    (GPIO_PIN_0 | GPIO_PIN_1)
+#define USB_PORT1_UART_RX_PIN       GPIO_PB0_U1RX
+#define USB_PORT1_UART_TX_PIN       GPIO_PB1_U1TX
+#define USB_PORT1_UART_UDMA_TX      UDMA_CHANNEL_UART1TX
+#define USB_PORT1_UART_UDMA_TX_MAP  UDMA_CH23_UART1TX
+#define USB_PORT1_UART_FLOW_PERIPH  SYSCTL_PERIPH_GPIOD
+#define USB_PORT1_UART_FLOW_BASE    GPIO_PORTD_BASE
+#define USB_PORT1_UART_FLOW_INT     INT_GPIOD
+#define USB_PORT1_UART_RTS_PIN      GPIO_PIN_2
+#define USB_PORT1_UART_CTS_PIN      GPIO_PIN_3
+#define USB_PORT1_UART_DTR_PIN      GPIO_PIN_6
+
+// UART3 on PC6/PC7 for the third port, with its handshake lines on
+// PB2 (RTS), PB3 (CTS) and PB4 (DTR).  driverlib has no UDMA_CHANNEL_ name
+// for the UART3 TX channel, so its number is taken from the channel map.
+#define USB_PORT2_UART_BASE         UART3_BASE
+#define USB_PORT2_UART_PERIPH       SYSCTL_PERIPH_UART3
+#define USB_PORT2_UART_INT          INT_UART3
+#define USB_PORT2_UART_GPIO_PERIPH  SYSCTL_PERIPH_GPIOC
+#define USB_PORT2_UART_GPIO_BASE    GPIO_PORTC_BASE
+#define USB_PORT2_UART_GPIO_PINS    (GPIO_PIN_6 | GPIO_PIN_7)
+#define USB_PORT2_UART_RX_PIN       GPIO_PC6_U3RX
+#define USB_PORT2_UART_TX_PIN       GPIO_PC7_U3TX
+#define USB_PORT2_UART_UDMA_TX      (UDMA_CH17_UART3TX & 0xff)
+#define USB_PORT2_UART_UDMA_TX_MAP  UDMA_CH17_UART3TX
+#define USB_PORT2_UART_FLOW_PERIPH  SYSCTL_PERIPH_GPIOB
+#define USB_PORT2_UART_FLOW_BASE    GPIO_PORTB_BASE
+#define USB_PORT2_UART_FLOW_INT     INT_GPIOB
+#define USB_PORT2_UART_RTS_PIN      GPIO_PIN_2
+#define USB_PORT2_UART_CTS_PIN      GPIO_PIN_3
+#define USB_PORT2_UART_DTR_PIN      GPIO_PIN_4
+
+// Endpoint FIFO RAM used for the double-buffered bulk data endpoints, 256
+// bytes per port.  This is well above anything usblib allocates for the CDC
+// configuration.
+#define USB_FIFO_DB_ADDR        1024
+
+// Interrupt priorities, applied by USBInit().  Lower values preempt higher
+// ones and only the top three bits are implemented.  The bridge UARTs and
+// their CTS inputs run above everything else so that their FIFOs are served
+// within a few character times however long the USB interrupt runs; they
+// never call into usblib and leave that to the deferred handler.  The USB
+// controller, SysTick and the deferred handler (PendSV) share the level
+// below and so never preempt each other, which usblib relies on.  Setting
+// both to the same value gives back the flat map, to compare the latencies
+// measured with USB_LATENCY_PROBE in usbprofile.h.
+#define USB_INT_PRIORITY_UART   0x20
+#define USB_INT_PRIORITY_USB    0x40
+
+// Rate of the SysTick interrupt that drives the driver's timers.
+#define USB_TICK_RATE           1000
+
+// Default latency timer in milliseconds.  Data for the host is held back
+// until a full packet is queued, the application calls USBTxFlush() or the
+// oldest byte has waited this long.  Zero sends every write straight away.
+#define USB_TX_LATENCY_DEFAULT  16
+
+// Budget for draining the OUT endpoint in one interrupt.  After the packet
+// that raised the interrupt, RxHandler() keeps reading packets already
+// waiting in the endpoint FIFO until USB_RX_BURST_BYTES bytes or
+// USB_RX_BURST_US microseconds have been spent, and then hands the whole
+// batch on at once.  Zero bytes reads one packet per interrupt.
+#ifndef USB_RX_BURST_BYTES
+#define USB_RX_BURST_BYTES      512
+#endif
+#ifndef USB_RX_BURST_US
+#define USB_RX_BURST_US         50
+#endif
+
+// A contiguous run of bytes inside one of the USB ring buffers.  Data that
+// wraps past the end of the ring is described by a second span starting at
+// the beginning of the ring storage.
+typedef struct
+{
+    uint8_t *pui8Data;
+    uint32_t ui32Size;
+} tUSBSpan;
+
+// Watermark statistics for the shared buffer arena.  ui32RxFull and
+// ui32TxFull count the events seen while a buffer had less than one packet
+// of space left, that is while the endpoint would be NAKed or the
+// application could not queue a full packet.
+typedef struct
+{
+    uint32_t ui32RxBlocks;
+    uint32_t ui32TxBlocks;
+    uint32_t ui32RxPeak;
+    uint32_t ui32TxPeak;
+    uint32_t ui32RxFull;
+    uint32_t ui32TxFull;
+    uint32_t ui32Rebalances;
+    uint32_t ui32RxPackets;
+    uint32_t ui32RxBursts;          // Interrupts that read RX packets.
+    uint32_t ui32RxBytes;           // Released with USBRxConsume().
+} tUSBBufferStats;
+
+extern tUSBBufferStats g_psUSBBufferStats[USB_PORTS];
+
+// Function prototypes.
 void USBInit(void);
-extern void RxDataHandler(void);
+uint32_t USBRxSpansGet(const tUSBBuffer *psBuffer, tUSBSpan *psSpans);
+void USBRxConsume(const tUSBBuffer *psBuffer, uint32_t ui32Count);
+void USBRxResume(uint32_t ui32Port);
+uint32_t USBTxSpansGet(const tUSBBuffer *psBuffer, tUSBSpan *psSpans);
+void USBTxCommit(const tUSBBuffer *psBuffer, uint32_t ui32Count);
+void USBSpansSkip(tUSBSpan *psSpans, uint32_t ui32Count);
+void USBCopy(uint8_t *pui8Dst, const uint8_t *pui8Src, uint32_t ui32Size);
+uint32_t USBForward(const tUSBBuffer *psRxBuffer, const tUSBBuffer *psTxBuffer);
+bool USBBufferRebalance(uint32_t ui32Port);
+void USBTxFlush(const tUSBBuffer *psBuffer);
+void USBTxLatencySet(uint32_t ui32Ms);
+uint32_t USBTxLatencyGet(void);
+void USBTickHandler(void);
+void USBTimeSample(uint32_t *pui32Ticks, uint32_t *pui32Count);
+uint32_t USBTimeToUs(uint32_t ui32Ticks, uint32_t ui32Count);
+uint32_t USBTimeGet(void);
+uint32_t USBCriticalEnter(void);
+void USBCriticalExit(uint32_t ui32Mask);
+extern void RxDataHandler(uint32_t ui32Port);
+extern void USBStatusHandler(uint32_t ui32Port, uint32_t ui32Event,
+                             uint32_t ui32Seq);
 
 #endif /* USBCONFIG_H_ */
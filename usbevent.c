@@ -0,0 +1,225 @@
+/*
+ * usbevent.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbevent.h"
+#include "usbcompress.h"
+#include "usbprofile.h"
+#include "usblog.h"
+
+//*****************************************************************************
+//
+// Multiple producer, single consumer ring of events.  Any interrupt may post
+// an event; producers claim a slot by advancing g_ui32EventWrite with
+// LDREX/STREX, fill it in and then publish it by writing its ready marker.
+// The main loop is the only consumer and the only writer of g_ui32EventRead.
+// Nothing here ever masks interrupts.  Both indices run freely and are
+// masked when the ring is accessed.
+//
+//*****************************************************************************
+typedef struct
+{
+    volatile uint32_t ui32Ready;    // Slot index + 1 once published.
+    uint32_t ui32Port;
+    uint32_t ui32Event;
+    uint32_t ui32Seq;
+} tUSBEventEntry;
+
+static tUSBEventEntry g_psEventRing[USB_EVENT_QUEUE_SIZE];
+static volatile uint32_t g_ui32EventWrite;
+static volatile uint32_t g_ui32EventRead;
+
+// Sequence number given to the next event.  It is advanced for every event
+// posted, including those dropped because the ring was full, so that the
+// application can spot lost events as gaps.
+static volatile uint32_t g_ui32EventSeq;
+
+// Bit EVENT_BIT(port, event) is set while an RX or TX event is queued for a
+// port.  Each of these tells the main loop to look at the port's buffers,
+// which covers every packet that arrives before it does so, so one queued
+// event of each kind per port is enough.
+static volatile uint32_t g_ui32EventQueued;
+
+#define EVENT_BIT(ui32Port, ui32Event)                                        \
+        (1 << (((ui32Port) * 8) + (ui32Event)))
+#define EVENT_COALESCE_MASK     ((1 << USB_EVT_RX_AVAILABLE) |                \
+                                 (1 << USB_EVT_TX_COMPLETE))
+
+// Events that could not be posted because the queue was full.
+uint32_t g_ui32USBEventOverflows;
+
+// Atomically add ui32Value to a word and return its previous value.
+static uint32_t AtomicAdd(volatile uint32_t *pui32Word, uint32_t ui32Value)
+{
+    uint32_t ui32Old;
+
+    do
+    {
+        ui32Old = __ldrex((void *)pui32Word);
+    }
+    while(__strex(ui32Old + ui32Value, (void *)pui32Word));
+
+    return(ui32Old);
+}
+
+// Atomically set or clear bits in a word and return its previous value.
+static uint32_t AtomicModify(volatile uint32_t *pui32Word, uint32_t ui32Set,
+                             uint32_t ui32Clear)
+{
+    uint32_t ui32Old;
+
+    do
+    {
+        ui32Old = __ldrex((void *)pui32Word);
+    }
+    while(__strex((ui32Old & ~ui32Clear) | ui32Set, (void *)pui32Word));
+
+    return(ui32Old);
+}
+
+// Queue an event on a port for the main loop.  This may be called from any
+// interrupt.  Returns false if the queue was full.
+bool USBEventPost(uint32_t ui32Port, uint32_t ui32Event)
+{
+    uint32_t ui32Bit, ui32Seq, ui32Write;
+    tUSBEventEntry *psEntry;
+
+    // Fold repeated data events into the one already waiting.
+    ui32Bit = ((1 << ui32Event) & EVENT_COALESCE_MASK) ?
+              EVENT_BIT(ui32Port, ui32Event) : 0;
+    if(ui32Bit && (AtomicModify(&g_ui32EventQueued, ui32Bit, 0) & ui32Bit))
+    {
+        return(true);
+    }
+
+    ui32Seq = AtomicAdd(&g_ui32EventSeq, 1);
+
+    // Claim the next slot unless the ring is full.
+    do
+    {
+        ui32Write = __ldrex((void *)&g_ui32EventWrite);
+        if((ui32Write - g_ui32EventRead) >= USB_EVENT_QUEUE_SIZE)
+        {
+            if(ui32Bit)
+            {
+                AtomicModify(&g_ui32EventQueued, 0, ui32Bit);
+            }
+            AtomicAdd(&g_ui32USBEventOverflows, 1);
+            USB_LOG(USB_LOG_EVENT_LOST, ui32Port, ui32Event);
+            return(false);
+        }
+    }
+    while(__strex(ui32Write + 1, (void *)&g_ui32EventWrite));
+
+    // Fill in the slot, then publish it.
+    psEntry = &g_psEventRing[ui32Write & (USB_EVENT_QUEUE_SIZE - 1)];
+    psEntry->ui32Port = ui32Port;
+    psEntry->ui32Event = ui32Event;
+    psEntry->ui32Seq = ui32Seq;
+    psEntry->ui32Ready = ui32Write + 1;
+    return(true);
+}
+
+// Returns true if there are events waiting for USBEventsProcess().
+bool USBEventPending(void)
+{
+    return(g_ui32EventRead != g_ui32EventWrite);
+}
+
+//*****************************************************************************
+//
+// Handles every event posted so far.  This must be called from the main loop.
+//
+// Data events call the application's RxDataHandler() for their port and give
+// the driver a chance to rebalance the port's buffer arena once both
+// directions are idle.  All other events are passed on to the application's
+// USBStatusHandler() along with their port and sequence number.
+//
+//*****************************************************************************
+void USBEventsProcess(void)
+{
+    uint32_t ui32Read, ui32Port, ui32Event, ui32Seq;
+    tUSBEventEntry *psEntry;
+
+    ui32Read = g_ui32EventRead;
+    while(ui32Read != g_ui32EventWrite)
+    {
+        // Stop at a slot that has been claimed but not yet published.  The
+        // producer will have finished by the next time the main loop runs.
+        psEntry = &g_psEventRing[ui32Read & (USB_EVENT_QUEUE_SIZE - 1)];
+        if(psEntry->ui32Ready != (ui32Read + 1))
+        {
+            break;
+        }
+        ui32Port = psEntry->ui32Port;
+        ui32Event = psEntry->ui32Event;
+        ui32Seq = psEntry->ui32Seq;
+        g_ui32EventRead = ++ui32Read;
+
+        // The queued flag is cleared before the buffers are looked at so
+        // that a packet arriving while the handler runs always queues a
+        // fresh event.
+        if((1 << ui32Event) & EVENT_COALESCE_MASK)
+        {
+            AtomicModify(&g_ui32EventQueued, 0, EVENT_BIT(ui32Port, ui32Event));
+        }
+
+        switch(ui32Event)
+        {
+            // New data has arrived from the host.
+            case USB_EVT_RX_AVAILABLE:
+            {
+                USB_PROBE_START();
+
+                RxDataHandler(ui32Port);
+                USB_PROBE_END(USB_PROBE_RX_DATA_HANDLER);
+                break;
+            }
+
+            // Space has been freed in the transmit buffer.  If the
+            // application had to leave received data queued because the
+            // transmit buffer was full, give it another chance to process
+            // it.  Otherwise both directions may be idle, which is the only
+            // time the arena split can be moved.
+            case USB_EVT_TX_COMPLETE:
+            {
+#ifdef USB_COMPRESS
+                // Coded data still waiting goes before anything new.
+                if(USBCompressDrain(ui32Port))
+                {
+                    break;
+                }
+#endif
+#ifndef USB_UART_BRIDGE
+                if(USBBufferDataAvailable(&g_psRxBuffer[ui32Port]))
+                {
+                    RxDataHandler(ui32Port);
+                    break;
+                }
+#endif
+                USBBufferRebalance(ui32Port);
+                break;
+            }
+
+            default:
+            {
+                USBStatusHandler(ui32Port, ui32Event, ui32Seq);
+                break;
+            }
+        }
+    }
+}
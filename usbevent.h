@@ -0,0 +1,32 @@
+/*
+ * usbevent.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBEVENT_H_
+#define USBEVENT_H_
+
+// Events posted by the USB interrupt for the main loop, each for one port.
+// Everything except the data events is passed on to the application's
+// USBStatusHandler().
+#define USB_EVT_RX_AVAILABLE    1
+#define USB_EVT_TX_COMPLETE     2
+#define USB_EVT_CONNECTED       3
+#define USB_EVT_DISCONNECTED    4
+#define USB_EVT_LINE_CODING     5
+#define USB_EVT_SUSPEND         6
+#define USB_EVT_RESUME          7
+
+// Number of entries in the event queue.  This must be a power of 2.
+#define USB_EVENT_QUEUE_SIZE    16
+
+// Events that could not be posted because the queue was full.
+extern uint32_t g_ui32USBEventOverflows;
+
+bool USBEventPost(uint32_t ui32Port, uint32_t ui32Event);
+bool USBEventPending(void);
+void USBEventsProcess(void);
+
+#endif /* USBEVENT_H_ */
@@ -0,0 +1,349 @@
+/*
+ * usbframe.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbframe.h"
+
+// Reflected CRC-32 polynomial (IEEE 802.3).
+#define CRC32_POLY              0xEDB88320
+
+//*****************************************************************************
+//
+// Slicing-by-4 CRC tables.  g_ppui32CRCTable[0] is the usual byte-at-a-time
+// table and g_ppui32CRCTable[n] advances a byte through n further zero
+// bytes, so four bytes can be folded in with four lookups.  They are built
+// in SRAM by USBFrameInit(), where lookups are quicker than from flash.
+//
+//*****************************************************************************
+static uint32_t g_ppui32CRCTable[4][256];
+
+// Build the CRC tables.  This must be called once before any other function
+// in this file.
+void USBFrameInit(void)
+{
+    uint32_t ui32Idx, ui32Bit, ui32CRC;
+
+    for(ui32Idx = 0; ui32Idx < 256; ui32Idx++)
+    {
+        ui32CRC = ui32Idx;
+        for(ui32Bit = 0; ui32Bit < 8; ui32Bit++)
+        {
+            ui32CRC = (ui32CRC >> 1) ^ ((ui32CRC & 1) ? CRC32_POLY : 0);
+        }
+        g_ppui32CRCTable[0][ui32Idx] = ui32CRC;
+    }
+
+    for(ui32Idx = 0; ui32Idx < 256; ui32Idx++)
+    {
+        ui32CRC = g_ppui32CRCTable[0][ui32Idx];
+        for(ui32Bit = 1; ui32Bit < 4; ui32Bit++)
+        {
+            ui32CRC = (ui32CRC >> 8) ^ g_ppui32CRCTable[0][ui32CRC & 0xFF];
+            g_ppui32CRCTable[ui32Bit][ui32Idx] = ui32CRC;
+        }
+    }
+}
+
+// Continue a CRC-32 over more data.  Start with 0; the result of one call can
+// be passed to the next to cover data in several pieces.
+uint32_t USBFrameCRC32(uint32_t ui32CRC, const uint8_t *pui8Data,
+                       uint32_t ui32Size)
+{
+    ui32CRC = ~ui32CRC;
+
+    // Bytes up to a word boundary.
+    while(ui32Size && ((uint32_t)pui8Data & 3))
+    {
+        ui32CRC = (ui32CRC >> 8) ^
+                  g_ppui32CRCTable[0][(ui32CRC ^ *pui8Data++) & 0xFF];
+        ui32Size--;
+    }
+
+    // Whole words, four lookups each.
+    while(ui32Size >= 4)
+    {
+        ui32CRC ^= *(const uint32_t *)pui8Data;
+        ui32CRC = g_ppui32CRCTable[3][ui32CRC & 0xFF] ^
+                  g_ppui32CRCTable[2][(ui32CRC >> 8) & 0xFF] ^
+                  g_ppui32CRCTable[1][(ui32CRC >> 16) & 0xFF] ^
+                  g_ppui32CRCTable[0][ui32CRC >> 24];
+        pui8Data += 4;
+        ui32Size -= 4;
+    }
+
+    // Trailing bytes.
+    while(ui32Size--)
+    {
+        ui32CRC = (ui32CRC >> 8) ^
+                  g_ppui32CRCTable[0][(ui32CRC ^ *pui8Data++) & 0xFF];
+    }
+
+    return(~ui32CRC);
+}
+
+// Prepare a decoder to decode frames of up to ui32Size bytes, CRC included,
+// into pui8Buffer.
+void USBFrameDecoderInit(tUSBFrameDecoder *psDecoder, uint8_t *pui8Buffer,
+                         uint32_t ui32Size, tUSBFrameCallback pfnCallback,
+                         void *pvCBData)
+{
+    memset(psDecoder, 0, sizeof(tUSBFrameDecoder));
+    psDecoder->pui8Frame = pui8Buffer;
+    psDecoder->ui32MaxSize = ui32Size;
+    psDecoder->pfnCallback = pfnCallback;
+    psDecoder->pvCBData = pvCBData;
+}
+
+// A delimiter has been seen.  Check the frame that has just ended, pass it to
+// the application if it is good and get ready for the next one.
+static void FrameEnd(tUSBFrameDecoder *psDecoder)
+{
+    uint8_t *pui8CRC;
+    uint32_t ui32Size, ui32CRC;
+
+    ui32Size = psDecoder->ui32Size;
+
+    if(psDecoder->bDiscard)
+    {
+        psDecoder->ui32Overflows++;
+    }
+    else if(psDecoder->ui32Run || ((ui32Size > 0) && (ui32Size < 4)))
+    {
+        psDecoder->ui32FramingErrors++;
+    }
+    else if(ui32Size)
+    {
+        // Back-to-back delimiters are just an idle line and are skipped.
+        ui32Size -= 4;
+        pui8CRC = &psDecoder->pui8Frame[ui32Size];
+        ui32CRC = (pui8CRC[0] | (pui8CRC[1] << 8) | (pui8CRC[2] << 16) |
+                   ((uint32_t)pui8CRC[3] << 24));
+        if(USBFrameCRC32(0, psDecoder->pui8Frame, ui32Size) == ui32CRC)
+        {
+            psDecoder->ui32Frames++;
+            psDecoder->pfnCallback(psDecoder->pvCBData, psDecoder->pui8Frame,
+                                   ui32Size);
+        }
+        else
+        {
+            psDecoder->ui32CRCErrors++;
+        }
+    }
+
+    psDecoder->ui32Size = 0;
+    psDecoder->ui32Run = 0;
+    psDecoder->bZeroPending = false;
+    psDecoder->bDiscard = false;
+}
+
+// Add decoded bytes to the frame, or throw the frame away if they do not fit.
+static void FrameAppend(tUSBFrameDecoder *psDecoder, const uint8_t *pui8Data,
+                        uint32_t ui32Size)
+{
+    if(psDecoder->bDiscard)
+    {
+        return;
+    }
+    if((psDecoder->ui32MaxSize - psDecoder->ui32Size) < ui32Size)
+    {
+        psDecoder->bDiscard = true;
+        return;
+    }
+    USBCopy(&psDecoder->pui8Frame[psDecoder->ui32Size], pui8Data, ui32Size);
+    psDecoder->ui32Size += ui32Size;
+}
+
+// Decode one contiguous run of received bytes.
+static void FrameDecodeSpan(tUSBFrameDecoder *psDecoder, const uint8_t *pui8Data,
+                            uint32_t ui32Size)
+{
+    const uint8_t *pui8Zero;
+    uint32_t ui32Chunk;
+    uint8_t ui8Code;
+    static const uint8_t ui8Zero = 0;
+
+    while(ui32Size)
+    {
+        if(psDecoder->ui32Run)
+        {
+            // Copy as much of the current block of literals as this span
+            // holds, straight from the ring into the frame.  A zero inside a
+            // block means the frame was cut short.
+            ui32Chunk = (psDecoder->ui32Run < ui32Size) ? psDecoder->ui32Run :
+                        ui32Size;
+            pui8Zero = memchr(pui8Data, 0, ui32Chunk);
+            if(pui8Zero)
+            {
+                ui32Chunk = pui8Zero - pui8Data;
+                FrameAppend(psDecoder, pui8Data, ui32Chunk);
+                pui8Data += ui32Chunk + 1;
+                ui32Size -= ui32Chunk + 1;
+                FrameEnd(psDecoder);
+                continue;
+            }
+            FrameAppend(psDecoder, pui8Data, ui32Chunk);
+            psDecoder->ui32Run -= ui32Chunk;
+            pui8Data += ui32Chunk;
+            ui32Size -= ui32Chunk;
+            continue;
+        }
+
+        ui8Code = *pui8Data++;
+        ui32Size--;
+
+        if(ui8Code == 0)
+        {
+            FrameEnd(psDecoder);
+        }
+        else
+        {
+            // A new block.  Every block except one of maximum length stands
+            // for its literals followed by a zero, but the zero is only added
+            // once we know another block follows rather than the delimiter.
+            if(psDecoder->bZeroPending)
+            {
+                FrameAppend(psDecoder, &ui8Zero, 1);
+            }
+            psDecoder->ui32Run = ui8Code - 1;
+            psDecoder->bZeroPending = (ui8Code != 0xFF);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Decode all the data waiting in a receive buffer.
+//
+// \param psDecoder is the decoder state.
+// \param psBuffer is the receive buffer to take data from.
+//
+// The data is decoded straight out of the ring into the decoder's frame
+// buffer, and the callback is called for every complete frame with a good
+// CRC.  Partial frames are kept in the decoder until the rest arrives.
+//
+// \return Returns the number of bytes consumed from the buffer.
+//
+//*****************************************************************************
+uint32_t USBFrameDecode(tUSBFrameDecoder *psDecoder, const tUSBBuffer *psBuffer)
+{
+    tUSBSpan psSpans[2];
+    uint32_t ui32Count;
+
+    ui32Count = USBRxSpansGet(psBuffer, psSpans);
+    FrameDecodeSpan(psDecoder, psSpans[0].pui8Data, psSpans[0].ui32Size);
+    FrameDecodeSpan(psDecoder, psSpans[1].pui8Data, psSpans[1].ui32Size);
+    USBRxConsume(psBuffer, ui32Count);
+
+    return(ui32Count);
+}
+
+// Position in the free space of a transmit buffer, which may wrap from the
+// first span into the second.
+typedef struct
+{
+    tUSBSpan *psSpans;
+    uint32_t ui32Index;
+} tFrameWriter;
+
+// Return a pointer to the byte at a given offset into the free space.
+static uint8_t *FrameWriterAt(tFrameWriter *psWriter, uint32_t ui32Index)
+{
+    if(ui32Index < psWriter->psSpans[0].ui32Size)
+    {
+        return(&psWriter->psSpans[0].pui8Data[ui32Index]);
+    }
+    return(&psWriter->psSpans[1].pui8Data[ui32Index -
+                                          psWriter->psSpans[0].ui32Size]);
+}
+
+// COBS encode a run of bytes.  pui32Code is the offset of the code byte for
+// the block being built, which is filled in once the block is finished.
+static void FrameEncodeRun(tFrameWriter *psWriter, uint32_t *pui32Code,
+                           const uint8_t *pui8Data, uint32_t ui32Size)
+{
+    uint8_t ui8Byte;
+
+    while(ui32Size--)
+    {
+        ui8Byte = *pui8Data++;
+        if(ui8Byte)
+        {
+            *FrameWriterAt(psWriter, psWriter->ui32Index++) = ui8Byte;
+        }
+
+        // Close the block on a zero, or once it holds 254 literals.
+        if(!ui8Byte || ((psWriter->ui32Index - *pui32Code) == 0xFF))
+        {
+            *FrameWriterAt(psWriter, *pui32Code) =
+                (uint8_t)(psWriter->ui32Index - *pui32Code);
+            *pui32Code = psWriter->ui32Index++;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Frame a payload and queue it for the host.
+//
+// \param psBuffer is the transmit buffer to write to.
+// \param pui8Data points to the payload.
+// \param ui32Size is the payload size.
+//
+// The payload and its CRC are COBS encoded straight into the free space of
+// the transmit buffer, with no intermediate copy.  Nothing is written unless
+// the whole frame is known to fit.
+//
+// \return Returns true if the frame was queued or false if there was not
+// enough space in the buffer.
+//
+//*****************************************************************************
+bool USBFrameEncode(const tUSBBuffer *psBuffer, const uint8_t *pui8Data,
+                    uint32_t ui32Size)
+{
+    tUSBSpan psSpans[2];
+    tFrameWriter sWriter;
+    uint32_t ui32CRC, ui32Code;
+    uint8_t pui8CRC[4];
+
+    if(USBTxSpansGet(psBuffer, psSpans) <
+       (ui32Size + USB_FRAME_OVERHEAD(ui32Size)))
+    {
+        return(false);
+    }
+
+    ui32CRC = USBFrameCRC32(0, pui8Data, ui32Size);
+    pui8CRC[0] = (uint8_t)ui32CRC;
+    pui8CRC[1] = (uint8_t)(ui32CRC >> 8);
+    pui8CRC[2] = (uint8_t)(ui32CRC >> 16);
+    pui8CRC[3] = (uint8_t)(ui32CRC >> 24);
+
+    // The first code byte goes at the start and the literals after it.
+    sWriter.psSpans = psSpans;
+    sWriter.ui32Index = 1;
+    ui32Code = 0;
+
+    FrameEncodeRun(&sWriter, &ui32Code, pui8Data, ui32Size);
+    FrameEncodeRun(&sWriter, &ui32Code, pui8CRC, 4);
+
+    // Close the last block and add the delimiter.
+    *FrameWriterAt(&sWriter, ui32Code) = (uint8_t)(sWriter.ui32Index - ui32Code);
+    *FrameWriterAt(&sWriter, sWriter.ui32Index++) = 0;
+
+    USBTxCommit(psBuffer, sWriter.ui32Index);
+    return(true);
+}
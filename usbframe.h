@@ -0,0 +1,68 @@
+/*
+ * usbframe.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBFRAME_H_
+#define USBFRAME_H_
+
+//*****************************************************************************
+//
+// Framing of binary records over the CDC byte stream.  Each frame is the
+// payload followed by its CRC-32 (IEEE 802.3, little endian), COBS encoded
+// so that it contains no zero bytes and terminated by a single zero byte.
+//
+//*****************************************************************************
+
+// Largest number of bytes USBFrameEncode() can add to a payload of the given
+// size: the CRC, one COBS code byte per 254 bytes plus the first one, and the
+// delimiter.
+#define USB_FRAME_OVERHEAD(ui32Size)                                          \
+        (4 + (((ui32Size) + 4) / 254) + 1 + 1)
+
+// Called by USBFrameDecode() for every frame with a good CRC.  The payload is
+// in the decoder's buffer and is only valid until the callback returns.
+typedef void (* tUSBFrameCallback)(void *pvCBData, uint8_t *pui8Frame,
+                                   uint32_t ui32Size);
+
+// State of a frame decoder.  The decoder keeps its place across packets so
+// frames can be split anywhere.
+typedef struct
+{
+    // Buffer the payload is decoded into and its size.
+    uint8_t *pui8Frame;
+    uint32_t ui32MaxSize;
+
+    // Function called for every good frame.
+    tUSBFrameCallback pfnCallback;
+    void *pvCBData;
+
+    // Bytes decoded so far, literal bytes left in the current COBS block,
+    // whether a zero has to be added before the next block and whether the
+    // rest of the frame is being thrown away.
+    uint32_t ui32Size;
+    uint32_t ui32Run;
+    bool bZeroPending;
+    bool bDiscard;
+
+    // Statistics.
+    uint32_t ui32Frames;
+    uint32_t ui32CRCErrors;
+    uint32_t ui32FramingErrors;
+    uint32_t ui32Overflows;
+} tUSBFrameDecoder;
+
+void USBFrameInit(void);
+uint32_t USBFrameCRC32(uint32_t ui32CRC, const uint8_t *pui8Data,
+                       uint32_t ui32Size);
+void USBFrameDecoderInit(tUSBFrameDecoder *psDecoder, uint8_t *pui8Buffer,
+                         uint32_t ui32Size, tUSBFrameCallback pfnCallback,
+                         void *pvCBData);
+uint32_t USBFrameDecode(tUSBFrameDecoder *psDecoder,
+                        const tUSBBuffer *psBuffer);
+bool USBFrameEncode(const tUSBBuffer *psBuffer, const uint8_t *pui8Data,
+                    uint32_t ui32Size);
+
+#endif /* USBFRAME_H_ */
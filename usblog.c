@@ -0,0 +1,162 @@
+/*
+ * usblog.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "utils/uartstdio.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usblog.h"
+
+#ifdef USB_LOGGING
+
+//*****************************************************************************
+//
+// Ring of log records.  Writers claim a sequence number by advancing
+// g_ui32LogWrite with LDREX/STREX and always take the slot it maps to,
+// overwriting the oldest record, so writing never waits or fails.  The slot's
+// ui32Seq is cleared while the record is filled in and then set to the
+// sequence number plus one.  Readers keep their own position, check ui32Seq
+// before and after copying a record and treat anything else as a record
+// still being written or already overwritten.  Nothing here masks
+// interrupts.
+//
+//*****************************************************************************
+static tUSBLogRecord g_psLogRing[USB_LOG_SIZE];
+static volatile uint32_t g_ui32LogWrite;
+
+#ifndef USB_UART_BRIDGE
+// Position of the main loop's console printer.
+static uint32_t g_ui32LogPrinted;
+
+// The format strings, indexed by message.
+#define USB_LOG_FORMAT(ui32Id, pcFormat)    pcFormat,
+static const char * const g_ppcLogFormats[USB_LOG_COUNT] =
+{
+    USB_LOG_MESSAGES(USB_LOG_FORMAT)
+};
+#undef USB_LOG_FORMAT
+#endif
+
+// Record a message.  This may be called from any context.
+void USBLogWrite(uint32_t ui32Id, uint32_t ui32Arg0, uint32_t ui32Arg1)
+{
+    uint32_t ui32Seq;
+    tUSBLogRecord *psRecord;
+
+    do
+    {
+        ui32Seq = __ldrex((void *)&g_ui32LogWrite);
+    }
+    while(__strex(ui32Seq + 1, (void *)&g_ui32LogWrite));
+
+    psRecord = &g_psLogRing[ui32Seq & (USB_LOG_SIZE - 1)];
+    psRecord->ui32Seq = 0;
+    USBTimeSample(&psRecord->ui32Ticks, &psRecord->ui32Count);
+    psRecord->ui32Id = ui32Id;
+    psRecord->pui32Args[0] = ui32Arg0;
+    psRecord->pui32Args[1] = ui32Arg1;
+    psRecord->ui32Seq = ui32Seq + 1;
+}
+
+// Copy the record with sequence number *pui32Seq and advance *pui32Seq past
+// it.  If that record has already been overwritten the oldest one still in
+// the ring is copied instead, so the records lost show up as a gap in the
+// sequence numbers.  Returns false if the record has not been written yet.
+bool USBLogRead(uint32_t *pui32Seq, tUSBLogRecord *psRecord)
+{
+    tUSBLogRecord *psSlot;
+    uint32_t ui32Write, ui32Seq;
+
+    while(1)
+    {
+        ui32Write = g_ui32LogWrite;
+        ui32Seq = *pui32Seq;
+        if(ui32Seq == ui32Write)
+        {
+            return(false);
+        }
+        if((ui32Write - ui32Seq) > USB_LOG_SIZE)
+        {
+            ui32Seq = ui32Write - USB_LOG_SIZE;
+            *pui32Seq = ui32Seq;
+        }
+
+        psSlot = &g_psLogRing[ui32Seq & (USB_LOG_SIZE - 1)];
+        if(psSlot->ui32Seq == (ui32Seq + 1))
+        {
+            psRecord->ui32Ticks = psSlot->ui32Ticks;
+            psRecord->ui32Count = psSlot->ui32Count;
+            psRecord->ui32Id = psSlot->ui32Id;
+            psRecord->pui32Args[0] = psSlot->pui32Args[0];
+            psRecord->pui32Args[1] = psSlot->pui32Args[1];
+
+            // Only keep the copy if the record was not rewritten under us.
+            if(psSlot->ui32Seq == (ui32Seq + 1))
+            {
+                psRecord->ui32Seq = ui32Seq + 1;
+                *pui32Seq = ui32Seq + 1;
+                return(true);
+            }
+        }
+        else if((int32_t)(psSlot->ui32Seq - (ui32Seq + 1)) <= 0)
+        {
+            // Claimed but still being written.
+            return(false);
+        }
+
+        // Overwritten; start again from the oldest record.
+    }
+}
+
+// Print the next log record to the uartstdio console.  This must be called
+// from the main loop, which it may block until the text has been sent.
+// Returns true if a record was printed.  With the bridge the console UART is
+// not available and the log can only be read by the host.
+bool USBLogPrint(void)
+{
+#ifndef USB_UART_BRIDGE
+    tUSBLogRecord sRecord;
+    uint32_t ui32Seq;
+
+    ui32Seq = g_ui32LogPrinted;
+    if(!USBLogRead(&g_ui32LogPrinted, &sRecord))
+    {
+        return(false);
+    }
+
+    if(sRecord.ui32Seq != (ui32Seq + 1))
+    {
+        UARTprintf("(%u lost)\n", sRecord.ui32Seq - 1 - ui32Seq);
+    }
+
+    UARTprintf("%10u ", USBTimeToUs(sRecord.ui32Ticks, sRecord.ui32Count));
+    if(sRecord.ui32Id < USB_LOG_COUNT)
+    {
+        UARTprintf(g_ppcLogFormats[sRecord.ui32Id], sRecord.pui32Args[0],
+                   sRecord.pui32Args[1]);
+    }
+    else
+    {
+        UARTprintf("message %u %x %x", sRecord.ui32Id, sRecord.pui32Args[0],
+                   sRecord.pui32Args[1]);
+    }
+    UARTprintf("\n");
+    return(true);
+#else
+    return(false);
+#endif
+}
+
+#endif
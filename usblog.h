@@ -0,0 +1,77 @@
+/*
+ * usblog.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBLOG_H_
+#define USBLOG_H_
+
+// Uncomment to record log messages.  When this is not defined the USB_LOG()
+// calls compile to nothing.
+//#define USB_LOGGING
+
+// Number of records kept, a power of two.  The oldest record is overwritten
+// when the ring is full.
+#define USB_LOG_SIZE            64
+
+// Most records returned by one USB_TELEMETRY_REQ_LOG request.
+#define USB_LOG_READ_MAX        16
+
+//*****************************************************************************
+//
+// The log messages.  Each message is recorded as its position in this list
+// and up to two 32-bit arguments; the format string is only used when the
+// record is printed, in the main loop or by host/logdecode.py, which reads
+// this list from this file.  Formats may use %d, %u, %x and %c.  Add new
+// messages at the end so that old logs still decode.
+//
+//*****************************************************************************
+#define USB_LOG_MESSAGES(MSG)                                                 \
+    MSG(USB_LOG_SUSPEND,        "bus suspended")                             \
+    MSG(USB_LOG_RESUME,         "bus resumed, first packet after %u us")     \
+    MSG(USB_LOG_LINE_CODING,    "port %u line coding %u baud")               \
+    MSG(USB_LOG_REBALANCE,      "port %u arena split %u rx blocks")          \
+    MSG(USB_LOG_EVENT_LOST,     "port %u event %u lost, queue full")         \
+    MSG(USB_LOG_CTS_STALL,      "port %u peer dropped CTS")
+
+#define USB_LOG_ID(ui32Id, pcFormat)    ui32Id,
+enum
+{
+    USB_LOG_MESSAGES(USB_LOG_ID)
+    USB_LOG_COUNT
+};
+#undef USB_LOG_ID
+
+// One log record, as stored in the ring and sent to the host.  ui32Seq is
+// the record's sequence number plus one once it is complete, so consumers
+// can tell records that are still being written or have been overwritten.
+// The time is the raw tick count and SysTick counter value; only the printer
+// turns it into microseconds, with USBTimeToUs() or in host/logdecode.py.
+typedef struct
+{
+    volatile uint32_t ui32Seq;
+    uint32_t ui32Ticks;             // USBTimeSample() when recorded.
+    uint32_t ui32Count;
+    uint32_t ui32Id;
+    uint32_t pui32Args[2];
+} tUSBLogRecord;
+
+#ifdef USB_LOGGING
+
+#define USB_LOG(ui32Id, ui32Arg0, ui32Arg1)                                   \
+        USBLogWrite((ui32Id), (ui32Arg0), (ui32Arg1))
+
+void USBLogWrite(uint32_t ui32Id, uint32_t ui32Arg0, uint32_t ui32Arg1);
+bool USBLogRead(uint32_t *pui32Seq, tUSBLogRecord *psRecord);
+bool USBLogPrint(void);
+
+#else
+
+#define USB_LOG(ui32Id, ui32Arg0, ui32Arg1)
+#define USBLogPrint()           (false)
+
+#endif
+
+#endif /* USBLOG_H_ */
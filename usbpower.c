@@ -0,0 +1,175 @@
+/*
+ * usbpower.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_sysctl.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/rom.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbevent.h"
+#include "usbpower.h"
+#include "usblog.h"
+
+// Suspend and resume counters.
+tUSBPowerStats g_sUSBPowerStats;
+
+// Set from the suspend event until the resume event.  Every port of a
+// composite device sees both, so only the first of each counts.
+static volatile bool g_bSuspended;
+
+// USBTimeGet() at the last resume, and whether the first packet after it is
+// still to come.
+static uint32_t g_ui32ResumeTime;
+static volatile bool g_bResumeTimed;
+
+// Pick the clocks to keep running while suspended.  The USB controller has to
+// stay clocked to see the resume; the bridge adds its own peripherals in
+// USBUARTInit().  Peripherals are only gated while the processor sleeps
+// suspended, so these settings do not affect the normal idle sleep.
+void USBPowerInit(void)
+{
+    g_bSuspended = false;
+    g_bResumeTimed = false;
+
+#ifdef USB_POWER_SAVE
+    ROM_SysCtlPeripheralSleepEnable(SYSCTL_PERIPH_USB0);
+    ROM_SysCtlPeripheralDeepSleepEnable(SYSCTL_PERIPH_USB0);
+
+    // Run deep sleep from the 16MHz internal oscillator with the PLL off.
+    SysCtlDeepSleepClockSet(SYSCTL_DSLP_DIV_1 | SYSCTL_DSLP_OSC_INT);
+#endif
+}
+
+// The host has suspended the bus.  Called from the USB interrupt.
+void USBPowerSuspend(void)
+{
+    if(!g_bSuspended)
+    {
+        g_bSuspended = true;
+        g_sUSBPowerStats.ui32Suspends++;
+        USB_LOG(USB_LOG_SUSPEND, 0, 0);
+    }
+}
+
+// The host has resumed the bus.  Start timing the resume and send whatever
+// was queued for the host while it was suspended.  Called from the USB
+// interrupt.
+void USBPowerResume(void)
+{
+    uint32_t ui32Port;
+
+    if(!g_bSuspended)
+    {
+        return;
+    }
+
+    g_bSuspended = false;
+    g_sUSBPowerStats.ui32Resumes++;
+    g_ui32ResumeTime = USBTimeGet();
+    g_bResumeTimed = true;
+
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        USBBufferDataWritten(&g_psTxBuffer[ui32Port], 0);
+    }
+}
+
+// A packet has been moved to or from the host.  The first one after a resume
+// gives the resume latency.  Called from the USB interrupt.
+void USBPowerDataMoved(void)
+{
+    uint32_t ui32Latency;
+
+    if(!g_bResumeTimed)
+    {
+        return;
+    }
+
+    g_bResumeTimed = false;
+    ui32Latency = USBTimeGet() - g_ui32ResumeTime;
+    g_sUSBPowerStats.ui32ResumeLatency = ui32Latency;
+    if(ui32Latency > g_sUSBPowerStats.ui32ResumeLatencyMax)
+    {
+        g_sUSBPowerStats.ui32ResumeLatencyMax = ui32Latency;
+    }
+    USB_LOG(USB_LOG_RESUME, ui32Latency, 0);
+}
+
+#ifdef USB_POWER_SAVE
+//*****************************************************************************
+//
+// Sleeps with the peripherals gated until the next interrupt.
+//
+// Interrupts are masked around the sleep.  A pending interrupt still ends
+// the sleep, so a resume arriving after the check is not missed, but its
+// handler only runs once the clocks are back.  This has to use PRIMASK rather
+// than USBCriticalEnter(): an interrupt masked by BASEPRI does not wake the
+// processor.  SysTick is stopped so that
+// the latency timer does not wake the processor every tick; nothing is sent
+// while the bus is suspended anyway.
+//
+//*****************************************************************************
+static void PowerSleep(void)
+{
+    ROM_IntMasterDisable();
+    if(!g_bSuspended || USBEventPending())
+    {
+        ROM_IntMasterEnable();
+        return;
+    }
+
+    ROM_SysTickDisable();
+    ROM_SysCtlPeripheralClockGating(true);
+
+#ifdef USB_UART_BRIDGE
+    ROM_SysCtlSleep();
+#else
+    ROM_SysCtlDeepSleep();
+
+    // The system clock switches back to the PLL on wake up, which has to
+    // lock again before the USB controller is usable.
+    while(!(HWREG(SYSCTL_PLLSTAT) & SYSCTL_PLLSTAT_LOCK))
+    {
+    }
+#endif
+
+    ROM_SysCtlPeripheralClockGating(false);
+    ROM_SysTickEnable();
+    g_sUSBPowerStats.ui32Sleeps++;
+    ROM_IntMasterEnable();
+}
+#endif
+
+// Wait for the next interrupt.  Called from the main loop once it has no
+// events left to handle.
+void USBPowerIdle(void)
+{
+#ifdef USB_POWER_SAVE
+    if(g_bSuspended)
+    {
+        PowerSleep();
+        return;
+    }
+#endif
+
+    // WFE is used rather than WFI since taking an interrupt sets the event
+    // register, so an event posted between the check and the sleep still
+    // wakes the processor straight away without having to mask interrupts
+    // around the check.
+    __asm("    wfe");
+}
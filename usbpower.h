@@ -0,0 +1,42 @@
+/*
+ * usbpower.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBPOWER_H_
+#define USBPOWER_H_
+
+// Uncomment to cut power while the host has the bus suspended.  The main
+// loop then sleeps with every peripheral the driver does not need gated: in
+// deep sleep on the internal oscillator, or in plain sleep when bridging, as
+// the bridged UARTs are clocked from the system clock and have to keep
+// receiving.  When this is not defined suspend and resume are only counted
+// and timed.
+//#define USB_POWER_SAVE
+
+// Suspend and resume counters.  The resume latency is the time from the
+// resume event to the first packet moved in either direction on any port, in
+// microseconds.  It is taken with USBTimeGet(), which stands still while
+// USB_POWER_SAVE has SysTick stopped, so it starts when the resume handler
+// runs, after the clocks are back and the PLL has locked, and leaves out the
+// wake up itself.  Nothing here counts the time spent asleep.
+typedef struct
+{
+    uint32_t ui32Suspends;
+    uint32_t ui32Resumes;
+    uint32_t ui32Sleeps;            // Times the processor slept suspended.
+    uint32_t ui32ResumeLatency;     // Latest resume latency.
+    uint32_t ui32ResumeLatencyMax;
+} tUSBPowerStats;
+
+extern tUSBPowerStats g_sUSBPowerStats;
+
+void USBPowerInit(void);
+void USBPowerSuspend(void);
+void USBPowerResume(void);
+void USBPowerDataMoved(void);
+void USBPowerIdle(void);
+
+#endif /* USBPOWER_H_ */
@@ -0,0 +1,188 @@
+/*
+ * usbprofile.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/rom.h"
+#include "usbprofile.h"
+
+// Longest interrupt latencies seen.
+tUSBLatencyStats g_sUSBLatencyStats;
+
+#ifdef USB_LATENCY_PROBE
+// Reload value of the probe timers.
+static uint32_t g_ui32LatencyLoad;
+
+// Start a probe timer.  Its priority is set with the others in USBInit().
+static void LatencyTimerStart(uint32_t ui32Periph, uint32_t ui32Base,
+                              uint32_t ui32Int)
+{
+    ROM_SysCtlPeripheralEnable(ui32Periph);
+    ROM_TimerConfigure(ui32Base, TIMER_CFG_PERIODIC);
+    ROM_TimerLoadSet(ui32Base, TIMER_A, g_ui32LatencyLoad);
+    ROM_TimerIntEnable(ui32Base, TIMER_TIMA_TIMEOUT);
+    ROM_IntEnable(ui32Int);
+    ROM_TimerEnable(ui32Base, TIMER_A);
+}
+
+// Handle a probe timeout.  The timer reloaded and started counting down
+// again when the interrupt was raised, so how far it has got is how long the
+// interrupt waited.
+static void LatencyTimerSample(uint32_t ui32Base, uint32_t *pui32Max)
+{
+    USBLatencyRecord(pui32Max,
+                     g_ui32LatencyLoad - ROM_TimerValueGet(ui32Base, TIMER_A));
+    ROM_TimerIntClear(ui32Base, TIMER_TIMA_TIMEOUT);
+}
+#endif
+
+// Clear the results and start the probe timers.
+void USBLatencyInit(void)
+{
+    g_sUSBLatencyStats.ui32Tick = 0;
+    g_sUSBLatencyStats.ui32USB = 0;
+    g_sUSBLatencyStats.ui32UART = 0;
+
+#ifdef USB_LATENCY_PROBE
+    g_ui32LatencyLoad = ((ROM_SysCtlClockGet() / 1000000) *
+                         USB_LATENCY_PROBE_US) - 1;
+    LatencyTimerStart(SYSCTL_PERIPH_TIMER0, TIMER0_BASE, INT_TIMER0A);
+    LatencyTimerStart(SYSCTL_PERIPH_TIMER1, TIMER1_BASE, INT_TIMER1A);
+#endif
+}
+
+// Keep the longest latency seen in *pui32Max.  Each maximum is only updated
+// from one interrupt.
+void USBLatencyRecord(uint32_t *pui32Max, uint32_t ui32Latency)
+{
+    if(ui32Latency > *pui32Max)
+    {
+        *pui32Max = ui32Latency;
+    }
+}
+
+// Interrupt handlers of the probe timers.  The vectors of TIMER0A and TIMER1A
+// have to point here in startup_ccs.c.
+void USBLatencyUSBIntHandler(void)
+{
+#ifdef USB_LATENCY_PROBE
+    LatencyTimerSample(TIMER0_BASE, &g_sUSBLatencyStats.ui32USB);
+#endif
+}
+
+void USBLatencyUARTIntHandler(void)
+{
+#ifdef USB_LATENCY_PROBE
+    LatencyTimerSample(TIMER1_BASE, &g_sUSBLatencyStats.ui32UART);
+#endif
+}
+
+#ifdef USB_PROFILE
+
+// Debug Exception and Monitor Control register and the DWT registers used
+// to run the cycle counter.
+#define DEMCR                   0xE000EDFC
+#define DEMCR_TRCENA            0x01000000
+#define DWT_CTRL                0xE0001000
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define DWT_CYCCNT              0xE0001004
+
+// Timing results for each probe.
+tUSBProfile g_psUSBProfile[USB_PROBE_COUNT];
+
+// Start the cycle counter and clear the results.
+void USBProfileInit(void)
+{
+    uint32_t ui32Probe, ui32Bucket;
+
+    HWREG(DEMCR) |= DEMCR_TRCENA;
+    HWREG(DWT_CYCCNT) = 0;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+
+    for(ui32Probe = 0; ui32Probe < USB_PROBE_COUNT; ui32Probe++)
+    {
+        g_psUSBProfile[ui32Probe].ui32Count = 0;
+        g_psUSBProfile[ui32Probe].ui32Min = 0xFFFFFFFF;
+        g_psUSBProfile[ui32Probe].ui32Max = 0;
+        for(ui32Bucket = 0; ui32Bucket < USB_PROFILE_BUCKETS; ui32Bucket++)
+        {
+            g_psUSBProfile[ui32Probe].pui32Buckets[ui32Bucket] = 0;
+        }
+    }
+}
+
+// Add one measurement to a probe.  Each probe is only ever recorded from one
+// context so no locking is needed.
+void USBProfileRecord(uint32_t ui32Probe, uint32_t ui32Time)
+{
+    tUSBProfile *psProfile;
+    uint32_t ui32Bucket;
+
+    psProfile = &g_psUSBProfile[ui32Probe];
+    psProfile->ui32Count++;
+    if(ui32Time < psProfile->ui32Min)
+    {
+        psProfile->ui32Min = ui32Time;
+    }
+    if(ui32Time > psProfile->ui32Max)
+    {
+        psProfile->ui32Max = ui32Time;
+    }
+
+    ui32Bucket = ui32Time >> USB_PROFILE_BUCKET_SHIFT;
+    if(ui32Bucket >= USB_PROFILE_BUCKETS)
+    {
+        ui32Bucket = USB_PROFILE_BUCKETS - 1;
+    }
+    psProfile->pui32Buckets[ui32Bucket]++;
+}
+
+// Return an upper bound on the given percentile (for example 50 or 99) of a
+// probe's measurements, taken from the end of the bucket it falls in and
+// limited to the largest value seen.
+uint32_t USBProfilePercentile(uint32_t ui32Probe, uint32_t ui32Percent)
+{
+    tUSBProfile *psProfile;
+    uint32_t ui32Target, ui32Seen, ui32Bucket, ui32Limit;
+
+    psProfile = &g_psUSBProfile[ui32Probe];
+    if(!psProfile->ui32Count)
+    {
+        return(0);
+    }
+
+    // Rank of the measurement we are looking for, rounded up.  The product is
+    // taken in 64 bits, since a probe passes 2^32 / 100 calls within hours.
+    ui32Target = (uint32_t)((((uint64_t)psProfile->ui32Count * ui32Percent) +
+                             99) / 100);
+
+    ui32Seen = 0;
+    for(ui32Bucket = 0; ui32Bucket < (USB_PROFILE_BUCKETS - 1); ui32Bucket++)
+    {
+        ui32Seen += psProfile->pui32Buckets[ui32Bucket];
+        if(ui32Seen >= ui32Target)
+        {
+            break;
+        }
+    }
+
+    ui32Limit = ((ui32Bucket + 1) << USB_PROFILE_BUCKET_SHIFT) - 1;
+    if((ui32Bucket == (USB_PROFILE_BUCKETS - 1)) ||
+       (ui32Limit > psProfile->ui32Max))
+    {
+        ui32Limit = psProfile->ui32Max;
+    }
+    return(ui32Limit);
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * usbprofile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBPROFILE_H_
+#define USBPROFILE_H_
+
+// Uncomment to time the USB callbacks.  When this is not defined the probes
+// compile to nothing.
+//#define USB_PROFILE
+
+// The code paths that are timed.
+#define USB_PROBE_RX_HANDLER        0
+#define USB_PROBE_TX_HANDLER        1
+#define USB_PROBE_CONTROL_HANDLER   2
+#define USB_PROBE_RX_DATA_HANDLER   3
+#define USB_PROBE_FORWARD           4   // Per 64 bytes copied.
+#define USB_PROBE_COUNT             5
+
+// Each probe keeps a histogram of USB_PROFILE_BUCKETS buckets, each
+// (1 << USB_PROFILE_BUCKET_SHIFT) cycles wide.  The last bucket also counts
+// everything longer.  The defaults cover about 40us at 50MHz in 1.3us steps.
+#define USB_PROFILE_BUCKETS         32
+#define USB_PROFILE_BUCKET_SHIFT    6
+
+// Uncomment to measure the worst interrupt latency at each priority level in
+// usbconfig.h.  Two spare timers interrupt every USB_LATENCY_PROBE_US, TIMER0
+// at the level of the USB interrupt and TIMER1 at that of the bridge UARTs,
+// and each records how long its interrupt waited between the timeout and its
+// handler.  SysTick records the same from its own counter.  Independent of
+// USB_PROFILE.
+//#define USB_LATENCY_PROBE
+
+// The probe period.  Being prime it drifts across the USB frames and the
+// SysTick period instead of locking to them.
+#define USB_LATENCY_PROBE_US        997
+
+// Longest interrupt latencies seen, in system clock cycles.
+typedef struct
+{
+    uint32_t ui32Tick;              // SysTick.
+    uint32_t ui32USB;               // At USB_INT_PRIORITY_USB.
+    uint32_t ui32UART;              // At USB_INT_PRIORITY_UART.
+} tUSBLatencyStats;
+
+extern tUSBLatencyStats g_sUSBLatencyStats;
+
+void USBLatencyInit(void);
+void USBLatencyRecord(uint32_t *pui32Max, uint32_t ui32Latency);
+void USBLatencyUSBIntHandler(void);
+void USBLatencyUARTIntHandler(void);
+
+// Timing results for one probe, in timestamp units.
+typedef struct
+{
+    uint32_t ui32Count;
+    uint32_t ui32Min;
+    uint32_t ui32Max;
+    uint32_t pui32Buckets[USB_PROFILE_BUCKETS];
+} tUSBProfile;
+
+#ifdef USB_PROFILE
+
+// The time source for the probes.  On the target this is the DWT cycle
+// counter; another build can supply its own monotonic counter instead.
+#ifndef USB_PROFILE_TIMESTAMP
+#define USB_PROFILE_TIMESTAMP() HWREG(0xE0001004)
+#endif
+
+// Start timing at the end of a function's declarations and stop before its
+// return.  Only one probe can be open per block.
+#define USB_PROBE_START()                                                     \
+        uint32_t ui32ProbeStart = USB_PROFILE_TIMESTAMP()
+#define USB_PROBE_END(ui32Probe)                                              \
+        USBProfileRecord((ui32Probe), USB_PROFILE_TIMESTAMP() - ui32ProbeStart)
+
+extern tUSBProfile g_psUSBProfile[USB_PROBE_COUNT];
+
+void USBProfileInit(void);
+void USBProfileRecord(uint32_t ui32Probe, uint32_t ui32Time);
+uint32_t USBProfilePercentile(uint32_t ui32Probe, uint32_t ui32Percent);
+
+#else
+
+#define USB_PROBE_START()
+#define USB_PROBE_END(ui32Probe)
+
+#endif
+
+#endif /* USBPROFILE_H_ */
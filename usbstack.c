@@ -0,0 +1,88 @@
+/*
+ * usbstack.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
+#include "usbstack.h"
+
+// Stack and nesting counters.
+tUSBStackStats g_sUSBStackStats;
+
+#ifdef USB_STACK_STATS
+// Linker variables that mark the bottom and the top of the stack.
+extern uint32_t __stack;
+extern uint32_t __STACK_TOP;
+
+// The active bits of the system handlers in NVIC_SYS_HND_CTRL.
+#define SYS_HND_ACTIVE  (NVIC_SYS_HND_CTRL_TICK | NVIC_SYS_HND_CTRL_PNDSV |   \
+                         NVIC_SYS_HND_CTRL_MON | NVIC_SYS_HND_CTRL_SVC |      \
+                         NVIC_SYS_HND_CTRL_USGA | NVIC_SYS_HND_CTRL_BUSA |    \
+                         NVIC_SYS_HND_CTRL_MEMA)
+
+// The lowest word found used by the last USBStackPeak().  The stack only ever
+// grows down into the paint, so the next search can stop here.
+static uint32_t *g_pui32StackLow = &__STACK_TOP;
+
+// Count the exceptions active right now, the one calling this included.
+// Called first thing from interrupt handlers and USB callbacks; an interrupt
+// that preempts the caller completes before the maximum is written back, so
+// nothing here needs to be atomic.
+void USBStackSample(void)
+{
+    uint32_t ui32Reg, ui32Active, ui32Depth;
+
+    ui32Depth = 0;
+    for(ui32Reg = NVIC_ACTIVE0; ui32Reg <= NVIC_ACTIVE4; ui32Reg += 4)
+    {
+        ui32Active = HWREG(ui32Reg);
+        while(ui32Active)
+        {
+            ui32Active &= ui32Active - 1;
+            ui32Depth++;
+        }
+    }
+
+    ui32Active = HWREG(NVIC_SYS_HND_CTRL) & SYS_HND_ACTIVE;
+    while(ui32Active)
+    {
+        ui32Active &= ui32Active - 1;
+        ui32Depth++;
+    }
+
+    if(ui32Depth > g_sUSBStackStats.ui32NestingMax)
+    {
+        g_sUSBStackStats.ui32NestingMax = ui32Depth;
+    }
+}
+
+#endif
+
+// Find the most stack ever used, in bytes, from the lowest word that no
+// longer holds USB_STACK_PAINT.  Only the paint below the previous result is
+// searched.  The main loop calls this on every pass, where the time it takes
+// holds nothing up; nothing else may, since the search position is not
+// protected.  Without USB_STACK_STATS the stack is not
+// painted and this returns 0.
+uint32_t USBStackPeak(void)
+{
+#ifdef USB_STACK_STATS
+    uint32_t *pui32Word;
+
+    pui32Word = &__stack;
+    while((pui32Word < g_pui32StackLow) && (*pui32Word == USB_STACK_PAINT))
+    {
+        pui32Word++;
+    }
+    g_pui32StackLow = pui32Word;
+
+    g_sUSBStackStats.ui32Size = (uint32_t)&__STACK_TOP - (uint32_t)&__stack;
+    g_sUSBStackStats.ui32Peak = (uint32_t)&__STACK_TOP - (uint32_t)pui32Word;
+#endif
+    return(g_sUSBStackStats.ui32Peak);
+}
@@ -0,0 +1,40 @@
+/*
+ * usbstack.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBSTACK_H_
+#define USBSTACK_H_
+
+// Uncomment to track stack use and interrupt nesting.  When this is not
+// defined the stack is not painted, the samples taken on entry to the
+// interrupt handlers compile to nothing and the counters stay zero.
+//#define USB_STACK_STATS
+
+// Value ResetISR() fills the unused stack with.  Words still holding it have
+// never been written.
+#define USB_STACK_PAINT             0xCAFEF00D
+
+// Stack usage and interrupt nesting.  The peak is found from the paint by the
+// main loop; the nesting depth is sampled on entry to each of the driver's
+// interrupt handlers and callbacks.  A depth of 1 means an
+// interrupt only ever preempted the main loop.
+typedef struct
+{
+    uint32_t ui32Size;              // Bytes reserved for the stack.
+    uint32_t ui32Peak;              // Most bytes ever used.
+    uint32_t ui32NestingMax;        // Most exceptions active at once.
+} tUSBStackStats;
+
+extern tUSBStackStats g_sUSBStackStats;
+
+#ifdef USB_STACK_STATS
+void USBStackSample(void);
+#else
+#define USBStackSample()
+#endif
+uint32_t USBStackPeak(void);
+
+#endif /* USBSTACK_H_ */
@@ -0,0 +1,226 @@
+/*
+ * usbtelemetry.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbuart.h"
+#include "usbevent.h"
+#include "usbpower.h"
+#include "usbprofile.h"
+#include "usblog.h"
+#include "usbstack.h"
+#include "usbcompress.h"
+#include "usbtelemetry.h"
+
+// The snapshot being sent.  It has to stay put until the last packet of the
+// control transfer has gone out.
+static tUSBTelemetry g_sTelemetry;
+
+// Reply to a latency timer read, kept for the same reason.
+static uint16_t g_ui16Latency;
+
+#ifdef USB_COMPRESS
+// Reply to a compression read.
+static uint16_t g_pui16Compress[2];
+#endif
+
+#ifdef USB_LOGGING
+// Reply to a log read.
+static tUSBLogRecord g_psLogReply[USB_LOG_READ_MAX];
+#endif
+
+// The class driver's handlers, with the request handler replaced by
+// TelemetryRequestHandler(), and the class driver's own request handler
+// which everything other than our vendor requests is passed on to.
+static tCustomHandlers g_sTelemetryHandlers;
+static tStdRequest g_pfnCDCRequestHandler;
+
+// Fill in g_sTelemetry from the live counters.  This runs in the USB
+// interrupt, but the bridge UART interrupts and the latency probe timer can
+// preempt it, so every counter is copied in one critical section: all of them
+// then come from the same moment and none is caught half updated.  The stack
+// peak is the one the main loop last found; scanning for it here would hold
+// the interrupts off for as long as the scan takes.
+static void TelemetrySnapshot(void)
+{
+    uint32_t ui32Mask;
+
+    g_sTelemetry.ui16Version = USB_TELEMETRY_VERSION;
+    g_sTelemetry.ui16Size = sizeof(g_sTelemetry);
+    g_sTelemetry.ui32Flags = 0;
+    g_sTelemetry.ui32Sequence++;
+    g_sTelemetry.ui32Ports = USB_PORTS;
+#ifdef USB_PROFILE
+    g_sTelemetry.ui32Flags |= USB_TELEMETRY_PROFILE;
+#endif
+
+    ui32Mask = USBCriticalEnter();
+    memcpy(g_sTelemetry.psBuffer, g_psUSBBufferStats,
+           sizeof(g_psUSBBufferStats));
+    memcpy(g_sTelemetry.psUART, g_psUSBUARTStats, sizeof(g_psUSBUARTStats));
+    memcpy(g_sTelemetry.psCompress, g_psUSBCompressStats,
+           sizeof(g_psUSBCompressStats));
+    g_sTelemetry.ui32EventOverflows = g_ui32USBEventOverflows;
+    g_sTelemetry.sPower = g_sUSBPowerStats;
+    g_sTelemetry.sStack = g_sUSBStackStats;
+    g_sTelemetry.sLatency = g_sUSBLatencyStats;
+#ifdef USB_PROFILE
+    memcpy(g_sTelemetry.psProfile, g_psUSBProfile, sizeof(g_psUSBProfile));
+#endif
+    USBCriticalExit(ui32Mask);
+}
+
+//*****************************************************************************
+//
+// Handles non-standard requests on endpoint 0.
+//
+// \param pvInstance is the CDC device instance.
+// \param psUSBRequest is the setup packet.
+//
+// Vendor requests addressed to the device are answered here; everything else
+// goes to the class driver as before.
+//
+//*****************************************************************************
+static void TelemetryRequestHandler(void *pvInstance, tUSBRequest *psUSBRequest)
+{
+    uint32_t ui32Size;
+
+    if(((psUSBRequest->bmRequestType & USB_RTYPE_TYPE_M) != USB_RTYPE_VENDOR) ||
+       ((psUSBRequest->bmRequestType & USB_RTYPE_RECIPIENT_M) !=
+        USB_RTYPE_DEVICE))
+    {
+        g_pfnCDCRequestHandler(pvInstance, psUSBRequest);
+        return;
+    }
+
+    switch(psUSBRequest->bRequest)
+    {
+        case USB_TELEMETRY_REQ_SNAPSHOT:
+        {
+            TelemetrySnapshot();
+            ui32Size = sizeof(g_sTelemetry);
+            if(psUSBRequest->wLength < ui32Size)
+            {
+                ui32Size = psUSBRequest->wLength;
+            }
+
+            // Acknowledge the setup packet and send the snapshot.
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, false);
+            USBDCDSendDataEP0(0, (uint8_t *)&g_sTelemetry, ui32Size);
+            break;
+        }
+
+        case USB_TELEMETRY_REQ_LATENCY:
+        {
+            if(psUSBRequest->bmRequestType & USB_RTYPE_DIR_IN)
+            {
+                g_ui16Latency = (uint16_t)USBTxLatencyGet();
+                ui32Size = sizeof(g_ui16Latency);
+                if(psUSBRequest->wLength < ui32Size)
+                {
+                    ui32Size = psUSBRequest->wLength;
+                }
+                USBDevEndpointDataAck(USB0_BASE, USB_EP_0, false);
+                USBDCDSendDataEP0(0, (uint8_t *)&g_ui16Latency, ui32Size);
+            }
+            else
+            {
+                // There is no data stage, so this also completes the request.
+                USBDevEndpointDataAck(USB0_BASE, USB_EP_0, true);
+                USBTxLatencySet(psUSBRequest->wValue);
+            }
+            break;
+        }
+
+#ifdef USB_LOGGING
+        case USB_TELEMETRY_REQ_LOG:
+        {
+            uint32_t ui32Seq, ui32Count;
+
+            ui32Seq = ((uint32_t)psUSBRequest->wIndex << 16) |
+                      psUSBRequest->wValue;
+            ui32Count = 0;
+            while((ui32Count < USB_LOG_READ_MAX) &&
+                  USBLogRead(&ui32Seq, &g_psLogReply[ui32Count]))
+            {
+                ui32Count++;
+            }
+
+            ui32Size = ui32Count * sizeof(tUSBLogRecord);
+            if(psUSBRequest->wLength < ui32Size)
+            {
+                ui32Size = psUSBRequest->wLength;
+            }
+            USBDevEndpointDataAck(USB0_BASE, USB_EP_0, false);
+            USBDCDSendDataEP0(0, (uint8_t *)g_psLogReply, ui32Size);
+            break;
+        }
+#endif
+
+#ifdef USB_COMPRESS
+        case USB_TELEMETRY_REQ_COMPRESS:
+        {
+            if(psUSBRequest->wIndex >= USB_PORTS)
+            {
+                USBDCDStallEP0(0);
+                break;
+            }
+
+            if(psUSBRequest->bmRequestType & USB_RTYPE_DIR_IN)
+            {
+                g_pui16Compress[0] = USBCompressRequested(psUSBRequest->wIndex);
+                g_pui16Compress[1] = USB_COMPRESS_BLOCK_SIZE;
+                ui32Size = sizeof(g_pui16Compress);
+                if(psUSBRequest->wLength < ui32Size)
+                {
+                    ui32Size = psUSBRequest->wLength;
+                }
+                USBDevEndpointDataAck(USB0_BASE, USB_EP_0, false);
+                USBDCDSendDataEP0(0, (uint8_t *)g_pui16Compress, ui32Size);
+            }
+            else
+            {
+                USBDevEndpointDataAck(USB0_BASE, USB_EP_0, true);
+                USBCompressRequest(psUSBRequest->wIndex,
+                                   psUSBRequest->wValue != 0);
+            }
+            break;
+        }
+#endif
+
+        // Stall anything we do not understand.
+        default:
+        {
+            USBDCDStallEP0(0);
+            break;
+        }
+    }
+}
+
+// Chain the vendor request handler in front of the request handler of the
+// device on the bus: the CDC class driver, or the composite driver when there
+// are several ports.  Called once after the class driver is initialised, in
+// the same critical section, so that the USB interrupt cannot run before the
+// handler is in place.
+void USBTelemetryInit(tDeviceInfo *psDevInfo)
+{
+    g_sTelemetryHandlers = *psDevInfo->psCallbacks;
+    g_pfnCDCRequestHandler = g_sTelemetryHandlers.pfnRequestHandler;
+    g_sTelemetryHandlers.pfnRequestHandler = TelemetryRequestHandler;
+    psDevInfo->psCallbacks = &g_sTelemetryHandlers;
+}
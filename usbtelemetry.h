@@ -0,0 +1,73 @@
+/*
+ * usbtelemetry.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBTELEMETRY_H_
+#define USBTELEMETRY_H_
+
+// Vendor specific requests handled on endpoint 0.  They are sent to the
+// device recipient, so they do not touch the CDC interfaces and can be
+// issued while the serial port is open.
+//
+// USB_TELEMETRY_REQ_SNAPSHOT (bmRequestType 0xC0) returns a tUSBTelemetry
+// snapshot, truncated to wLength.
+#define USB_TELEMETRY_REQ_SNAPSHOT  0x01
+
+// USB_TELEMETRY_REQ_LATENCY sets the latency timer for data to the host to
+// wValue milliseconds (bmRequestType 0x40, no data stage) or returns the
+// current setting as a 16-bit value (bmRequestType 0xC0).
+#define USB_TELEMETRY_REQ_LATENCY   0x02
+
+// USB_TELEMETRY_REQ_LOG (bmRequestType 0xC0) returns up to USB_LOG_READ_MAX
+// tUSBLogRecord records starting at sequence number (wIndex << 16) | wValue,
+// or at the oldest record still kept if that one has been overwritten.  An
+// empty reply means there is nothing newer.  Reading does not remove records
+// from the log.  Stalled unless USB_LOGGING is defined in usblog.h.
+#define USB_TELEMETRY_REQ_LOG       0x03
+
+// USB_TELEMETRY_REQ_COMPRESS switches compression of the data sent on port
+// wIndex on (wValue 1) or off (wValue 0) (bmRequestType 0x40, no data
+// stage), or returns two 16-bit values, 1 if it is on or about to be and the
+// block size (bmRequestType 0xC0).  Stalled unless USB_COMPRESS is defined
+// in usbcompress.h.
+#define USB_TELEMETRY_REQ_COMPRESS  0x04
+
+// Layout version of tUSBTelemetry.  This must be bumped whenever the layout
+// changes, along with the host reader in host/telemetry.py.
+#define USB_TELEMETRY_VERSION       9
+
+// Set in ui32Flags when the profile histograms follow the fixed counters.
+#define USB_TELEMETRY_PROFILE       0x00000001
+
+//*****************************************************************************
+//
+// Snapshot of all driver counters.  Every member is a 32-bit word (or a pair
+// of 16-bit ones) so the structure has no padding and is sent to the host
+// as-is, little endian.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint16_t ui16Version;
+    uint16_t ui16Size;
+    uint32_t ui32Flags;
+    uint32_t ui32Sequence;
+    uint32_t ui32Ports;
+    tUSBBufferStats psBuffer[USB_PORTS];
+    tUSBUARTStats psUART[USB_PORTS];
+    tUSBCompressStats psCompress[USB_PORTS];
+    uint32_t ui32EventOverflows;
+    tUSBPowerStats sPower;
+    tUSBStackStats sStack;
+    tUSBLatencyStats sLatency;
+#ifdef USB_PROFILE
+    tUSBProfile psProfile[USB_PROBE_COUNT];
+#endif
+} tUSBTelemetry;
+
+void USBTelemetryInit(tDeviceInfo *psDevInfo);
+
+#endif /* USBTELEMETRY_H_ */
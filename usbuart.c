@@ -0,0 +1,776 @@
+/*
+ * usbuart.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_uart.h"
+#include "driverlib/gpio.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "driverlib/rom.h"
+#include "usblib/usblib.h"
+#include "usblib/usbcdc.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdcdc.h"
+#include "usblib/device/usbdcomp.h"
+#include "usb_structs.h"
+#include "usbconfig.h"
+#include "usbuart.h"
+#include "usbpower.h"
+#include "usblog.h"
+#include "usbstack.h"
+
+// Counters for the USB to UART bridge, per port.
+tUSBUARTStats g_psUSBUARTStats[USB_PORTS];
+
+// The UART and pins behind each port, from the defines in usbconfig.h.
+const tUSBUARTPort g_psUSBUARTPorts[USB_PORTS] =
+{
+    {
+        USB_UART_BASE, USB_UART_PERIPH, USB_UART_INT,
+        USB_UART_GPIO_PERIPH, USB_UART_GPIO_BASE, USB_UART_GPIO_PINS,
+        USB_UART_RX_PIN, USB_UART_TX_PIN,
+        USB_UART_UDMA_TX, USB_UART_UDMA_TX_MAP,
+        USB_UART_FLOW_PERIPH, USB_UART_FLOW_BASE, USB_UART_FLOW_INT,
+        USB_UART_RTS_PIN, USB_UART_CTS_PIN, USB_UART_DTR_PIN
+    },
+#if USB_PORTS > 1
+    {
+        USB_PORT1_UART_BASE, USB_PORT1_UART_PERIPH, USB_PORT1_UART_INT,
+        USB_PORT1_UART_GPIO_PERIPH, USB_PORT1_UART_GPIO_BASE,
+        USB_PORT1_UART_GPIO_PINS,
+        USB_PORT1_UART_RX_PIN, USB_PORT1_UART_TX_PIN,
+        USB_PORT1_UART_UDMA_TX, USB_PORT1_UART_UDMA_TX_MAP,
+        USB_PORT1_UART_FLOW_PERIPH, USB_PORT1_UART_FLOW_BASE,
+        USB_PORT1_UART_FLOW_INT,
+        USB_PORT1_UART_RTS_PIN, USB_PORT1_UART_CTS_PIN, USB_PORT1_UART_DTR_PIN
+    },
+#endif
+#if USB_PORTS > 2
+    {
+        USB_PORT2_UART_BASE, USB_PORT2_UART_PERIPH, USB_PORT2_UART_INT,
+        USB_PORT2_UART_GPIO_PERIPH, USB_PORT2_UART_GPIO_BASE,
+        USB_PORT2_UART_GPIO_PINS,
+        USB_PORT2_UART_RX_PIN, USB_PORT2_UART_TX_PIN,
+        USB_PORT2_UART_UDMA_TX, USB_PORT2_UART_UDMA_TX_MAP,
+        USB_PORT2_UART_FLOW_PERIPH, USB_PORT2_UART_FLOW_BASE,
+        USB_PORT2_UART_FLOW_INT,
+        USB_PORT2_UART_RTS_PIN, USB_PORT2_UART_CTS_PIN, USB_PORT2_UART_DTR_PIN
+    },
+#endif
+};
+
+#ifdef USB_UART_UDMA
+//*****************************************************************************
+//
+// The uDMA channel control table.  It must be aligned on a 1024 byte boundary.
+//
+//*****************************************************************************
+#pragma DATA_ALIGN(g_psDMAControlTable, 1024)
+tDMAControlTable g_psDMAControlTable[64];
+
+// The largest number of items a single basic mode uDMA transfer can move.
+#define UDMA_MAX_TRANSFER       1024
+
+// Number of bytes in the uDMA transfer currently feeding each port's UART, or
+// 0 while the channel is idle.
+static volatile uint32_t g_pui32DMATxCount[USB_PORTS];
+#endif
+
+// While a line coding change is waiting on a port, only the data the host
+// sent before it may reach the UART.  g_pui32TxAllowance counts the part of
+// it that has not been handed to the UART yet; the rest of the receive buffer
+// is held until USBUARTConfigure() applies the new coding.  Both are shared
+// with the UART interrupt and only changed elsewhere in critical sections.
+static volatile bool g_pbTxHeld[USB_PORTS];
+static volatile uint32_t g_pui32TxAllowance[USB_PORTS];
+
+// Work the UART interrupts leave to USBUARTDeferredIntHandler(), which runs
+// at the priority of the USB interrupt and so, unlike them, may call into
+// usblib.  g_pui32TxTaken counts the bytes at the front of a port's USB
+// receive buffer that have already gone to the UART, g_pui32RxStaged the
+// bytes from the UART written past the end of the data in its USB transmit
+// buffer, and g_pui16RxState the line errors not yet reported to the host.
+// The UART interrupts only ever add to them; the deferred handler takes them
+// in a critical section.
+static volatile uint32_t g_pui32TxTaken[USB_PORTS];
+static volatile uint32_t g_pui32RxStaged[USB_PORTS];
+static volatile uint16_t g_pui16RxState[USB_PORTS];
+
+#ifdef USB_UART_FLOW_CONTROL
+// Whether the host has asserted RTS on each port, and whether the buffer to
+// the host is too full to take more data from the peer.  RTS is only asserted
+// to the peer while the first is true and the second false.
+static bool g_pbHostRTS[USB_PORTS];
+static bool g_pbThrottled[USB_PORTS];
+
+// Drive the RTS pin of a port from the host's request and the buffer level.
+static void FlowRTSSet(uint32_t ui32Port)
+{
+    const tUSBUARTPort *psUART;
+
+    psUART = &g_psUSBUARTPorts[ui32Port];
+    ROM_GPIOPinWrite(psUART->ui32FlowBase, psUART->ui8RTSPin,
+                     (g_pbHostRTS[ui32Port] && !g_pbThrottled[ui32Port]) ?
+                     0 : psUART->ui8RTSPin);
+}
+
+// Return true if the peer on a port has CTS asserted and is ready for data.
+static bool FlowCTS(uint32_t ui32Port)
+{
+    const tUSBUARTPort *psUART;
+
+    psUART = &g_psUSBUARTPorts[ui32Port];
+    return(ROM_GPIOPinRead(psUART->ui32FlowBase, psUART->ui8CTSPin) == 0);
+}
+#endif
+
+// Initialise the UARTs on the other side of the bridge, one per port.
+void USBUARTInit(void)
+{
+    const tUSBUARTPort *psUART;
+    uint32_t ui32Port;
+
+#ifdef USB_UART_UDMA
+    // The uDMA controller is shared by all ports.
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    ROM_uDMAEnable();
+    ROM_uDMAControlBaseSet(g_psDMAControlTable);
+#ifdef USB_POWER_SAVE
+    ROM_SysCtlPeripheralSleepEnable(SYSCTL_PERIPH_UDMA);
+#endif
+#endif
+
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        psUART = &g_psUSBUARTPorts[ui32Port];
+
+        ROM_SysCtlPeripheralEnable(psUART->ui32GPIOPeriph);
+        ROM_SysCtlPeripheralEnable(psUART->ui32Periph);
+
+        // Configure GPIO Pins for UART mode.
+        ROM_GPIOPinConfigure(psUART->ui32RxPinConfig);
+        ROM_GPIOPinConfigure(psUART->ui32TxPinConfig);
+        ROM_GPIOPinTypeUART(psUART->ui32GPIOBase, psUART->ui32GPIOPins);
+
+#ifdef USB_POWER_SAVE
+        // Keep the bridge running while the processor sleeps suspended.
+        ROM_SysCtlPeripheralSleepEnable(psUART->ui32GPIOPeriph);
+        ROM_SysCtlPeripheralSleepEnable(psUART->ui32Periph);
+#ifdef USB_UART_FLOW_CONTROL
+        ROM_SysCtlPeripheralSleepEnable(psUART->ui32FlowPeriph);
+#endif
+#endif
+
+        // Clock the UART from the system clock so that rates up to a
+        // sixteenth of it are available, and start at the default rate with
+        // 8N1 until the host sends its line coding.
+        UARTClockSourceSet(psUART->ui32Base, UART_CLOCK_SYSTEM);
+        ROM_UARTConfigSetExpClk(psUART->ui32Base, ROM_SysCtlClockGet(),
+                                USB_UART_DEFAULT_BAUD,
+                                (UART_CONFIG_WLEN_8 | UART_CONFIG_PAR_NONE |
+                                 UART_CONFIG_STOP_ONE));
+
+        // Interrupt when the TX FIFO has drained to half full, which leaves
+        // eight character times to refill it, and when the RX FIFO is half
+        // full or the line has gone idle with data still in it.
+        ROM_UARTFIFOLevelSet(psUART->ui32Base, UART_FIFO_TX4_8,
+                             UART_FIFO_RX4_8);
+        UARTTxIntModeSet(psUART->ui32Base, UART_TXINT_MODE_FIFO);
+
+#ifdef USB_UART_UDMA
+        // Let the uDMA controller feed the TX FIFO in bursts of four whenever
+        // it has drained to the watermark.
+        uDMAChannelAssign(psUART->ui32DMAMap);
+        ROM_uDMAChannelAttributeDisable(psUART->ui32DMAChannel, UDMA_ATTR_ALL);
+        ROM_uDMAChannelControlSet(psUART->ui32DMAChannel | UDMA_PRI_SELECT,
+                                  (UDMA_SIZE_8 | UDMA_SRC_INC_8 |
+                                   UDMA_DST_INC_NONE | UDMA_ARB_4));
+        ROM_UARTDMAEnable(psUART->ui32Base, UART_DMA_TX);
+#endif
+
+#ifdef USB_UART_FLOW_CONTROL
+        // RTS and DTR start deasserted until the host opens the port.  CTS
+        // has a pull-up so that an unconnected input holds the data back,
+        // and interrupts on both edges.
+        ROM_SysCtlPeripheralEnable(psUART->ui32FlowPeriph);
+        ROM_GPIOPinTypeGPIOOutput(psUART->ui32FlowBase,
+                                  psUART->ui8RTSPin | psUART->ui8DTRPin);
+        ROM_GPIOPinWrite(psUART->ui32FlowBase,
+                         psUART->ui8RTSPin | psUART->ui8DTRPin,
+                         psUART->ui8RTSPin | psUART->ui8DTRPin);
+        ROM_GPIOPinTypeGPIOInput(psUART->ui32FlowBase, psUART->ui8CTSPin);
+        ROM_GPIOPadConfigSet(psUART->ui32FlowBase, psUART->ui8CTSPin,
+                             GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+        GPIOIntTypeSet(psUART->ui32FlowBase, psUART->ui8CTSPin,
+                       GPIO_BOTH_EDGES);
+        GPIOIntClear(psUART->ui32FlowBase, psUART->ui8CTSPin);
+        GPIOIntEnable(psUART->ui32FlowBase, psUART->ui8CTSPin);
+        ROM_IntEnable(psUART->ui32FlowInt);
+#endif
+
+        ROM_UARTIntClear(psUART->ui32Base,
+                         ROM_UARTIntStatus(psUART->ui32Base, false));
+        ROM_UARTIntEnable(psUART->ui32Base, UART_INT_RX | UART_INT_RT);
+        ROM_IntEnable(psUART->ui32Int);
+    }
+}
+
+// Describe the data in a port's USB receive buffer that has not gone to the
+// UART yet.  Returns its size.
+static uint32_t TxSpansGet(uint32_t ui32Port, tUSBSpan *psSpans)
+{
+    uint32_t ui32Count, ui32Taken;
+
+    ui32Taken = g_pui32TxTaken[ui32Port];
+    ui32Count = USBRxSpansGet(&g_psRxBuffer[ui32Port], psSpans);
+    USBSpansSkip(psSpans, ui32Taken);
+    return(ui32Count - ui32Taken);
+}
+
+// Describe the free space in a port's USB transmit buffer past the data the
+// UART has already put there.  Returns its size.
+static uint32_t RxSpansGet(uint32_t ui32Port, tUSBSpan *psSpans)
+{
+    uint32_t ui32Free, ui32Staged;
+
+    ui32Staged = g_pui32RxStaged[ui32Port];
+    ui32Free = USBTxSpansGet(&g_psTxBuffer[ui32Port], psSpans);
+    USBSpansSkip(psSpans, ui32Staged);
+    return(ui32Free - ui32Staged);
+}
+
+#ifdef USB_UART_UDMA
+// Start a uDMA transfer of the first contiguous span of a port's USB receive
+// buffer that has not gone to the UART yet into its UART TX FIFO.  Only one
+// transfer per port is in flight at a time; the UART interrupt hands the
+// bytes on to the deferred handler once it completes and starts the next
+// one.  This only runs at the priority of the UART interrupts.
+static void UARTTxFill(uint32_t ui32Port)
+{
+    const tUSBUARTPort *psUART;
+    tUSBSpan psSpans[2];
+    uint32_t ui32Count;
+
+    if(g_pui32DMATxCount[ui32Port])
+    {
+        return;
+    }
+
+#ifdef USB_UART_FLOW_CONTROL
+    // Hold the data while the peer has CTS dropped.  The CTS interrupt
+    // restarts the pump.
+    if(!FlowCTS(ui32Port))
+    {
+        return;
+    }
+#endif
+
+    psUART = &g_psUSBUARTPorts[ui32Port];
+    TxSpansGet(ui32Port, psSpans);
+    ui32Count = psSpans[0].ui32Size;
+    if(ui32Count > UDMA_MAX_TRANSFER)
+    {
+        ui32Count = UDMA_MAX_TRANSFER;
+    }
+    if(g_pbTxHeld[ui32Port] && (ui32Count > g_pui32TxAllowance[ui32Port]))
+    {
+        ui32Count = g_pui32TxAllowance[ui32Port];
+    }
+
+    if(ui32Count)
+    {
+        if(g_pbTxHeld[ui32Port])
+        {
+            g_pui32TxAllowance[ui32Port] -= ui32Count;
+        }
+        g_pui32DMATxCount[ui32Port] = ui32Count;
+        ROM_uDMAChannelTransferSet(psUART->ui32DMAChannel | UDMA_PRI_SELECT,
+                                   UDMA_MODE_BASIC, psSpans[0].pui8Data,
+                                   (void *)(psUART->ui32Base + UART_O_DR),
+                                   ui32Count);
+        ROM_uDMAChannelEnable(psUART->ui32DMAChannel);
+    }
+}
+#else
+// Move as much data from a port's USB receive buffer into its UART TX FIFO as
+// it will hold.  The TX interrupt is left enabled while data is still waiting
+// so that the FIFO is topped up again as it drains.  This only runs at the
+// priority of the UART interrupts.
+static void UARTTxFill(uint32_t ui32Port)
+{
+    uint32_t ui32Base;
+    tUSBSpan psSpans[2];
+    uint8_t *pui8Data;
+    uint32_t ui32Count, ui32Size, ui32Span, ui32Sent, ui32Loop;
+
+    ui32Base = g_psUSBUARTPorts[ui32Port].ui32Base;
+
+#ifdef USB_UART_FLOW_CONTROL
+    // Hold the data while the peer has CTS dropped.  The CTS interrupt
+    // restarts the pump.
+    if(!FlowCTS(ui32Port))
+    {
+        ROM_UARTIntDisable(ui32Base, UART_INT_TX);
+        return;
+    }
+#endif
+
+    ui32Count = TxSpansGet(ui32Port, psSpans);
+    if(g_pbTxHeld[ui32Port] && (ui32Count > g_pui32TxAllowance[ui32Port]))
+    {
+        ui32Count = g_pui32TxAllowance[ui32Port];
+    }
+    ui32Sent = 0;
+
+    for(ui32Loop = 0; (ui32Loop < 2) && (ui32Sent < ui32Count); ui32Loop++)
+    {
+        pui8Data = psSpans[ui32Loop].pui8Data;
+        ui32Span = psSpans[ui32Loop].ui32Size;
+        if(ui32Span > (ui32Count - ui32Sent))
+        {
+            ui32Span = ui32Count - ui32Sent;
+        }
+        ui32Size = ui32Span;
+        while(ui32Size && ROM_UARTSpaceAvail(ui32Base))
+        {
+            ROM_UARTCharPutNonBlocking(ui32Base, *pui8Data++);
+            ui32Size--;
+        }
+        ui32Sent += ui32Span - ui32Size;
+
+        // Stop if the FIFO filled up before the span was finished.
+        if(ui32Size)
+        {
+            break;
+        }
+    }
+
+    if(ui32Sent)
+    {
+        g_pui32TxTaken[ui32Port] += ui32Sent;
+        g_psUSBUARTStats[ui32Port].ui32TxBytes += ui32Sent;
+        if(g_pbTxHeld[ui32Port])
+        {
+            g_pui32TxAllowance[ui32Port] -= ui32Sent;
+        }
+        ROM_IntPendSet(FAULT_PENDSV);
+    }
+
+    if(ui32Sent < ui32Count)
+    {
+        ROM_UARTIntEnable(ui32Base, UART_INT_TX);
+    }
+    else
+    {
+        ROM_UARTIntDisable(ui32Base, UART_INT_TX);
+    }
+}
+#endif
+
+// Start moving data from a port's USB receive buffer to its UART.  The work
+// is done by the UART interrupt, which is only made pending here, so this may
+// be called from any context.
+void USBUARTTxPump(uint32_t ui32Port)
+{
+    ROM_IntPendSet(g_psUSBUARTPorts[ui32Port].ui32Int);
+}
+
+// Move everything in a port's UART RX FIFO straight into its USB transmit
+// buffer, counting line errors on the way.  The deferred handler then hands
+// the data and the errors to the host.  This runs at the priority of the
+// UART interrupts or in a critical section.
+static void UARTRxDrain(uint32_t ui32Port)
+{
+    tUSBUARTStats *psStats;
+    tUSBSpan psSpans[2];
+    uint32_t ui32Base, ui32Free, ui32Count;
+    uint16_t ui16State;
+    int32_t i32Char;
+
+    ui32Base = g_psUSBUARTPorts[ui32Port].ui32Base;
+    psStats = &g_psUSBUARTStats[ui32Port];
+    ui32Free = RxSpansGet(ui32Port, psSpans);
+    ui32Count = 0;
+    ui16State = 0;
+
+    while(ROM_UARTCharsAvail(ui32Base))
+    {
+        i32Char = ROM_UARTCharGetNonBlocking(ui32Base);
+
+        // The upper bits of the data register flag line errors.
+        if(i32Char & UART_DR_OE)
+        {
+            psStats->ui32RxOverruns++;
+            ui16State |= USB_CDC_SERIAL_STATE_OVERRUN;
+        }
+        if(i32Char & UART_DR_PE)
+        {
+            psStats->ui32RxParityErrors++;
+            ui16State |= USB_CDC_SERIAL_STATE_PARITY;
+        }
+        if(i32Char & UART_DR_FE)
+        {
+            psStats->ui32RxFramingErrors++;
+            ui16State |= USB_CDC_SERIAL_STATE_FRAMING;
+        }
+
+        // A break is reported to the host but is not data.
+        if(i32Char & UART_DR_BE)
+        {
+            psStats->ui32RxBreaks++;
+            ui16State |= USB_CDC_SERIAL_STATE_BREAK;
+            continue;
+        }
+
+        if(ui32Count < psSpans[0].ui32Size)
+        {
+            psSpans[0].pui8Data[ui32Count++] = (uint8_t)i32Char;
+        }
+        else if(ui32Count < ui32Free)
+        {
+            psSpans[1].pui8Data[ui32Count++ - psSpans[0].ui32Size] =
+                (uint8_t)i32Char;
+        }
+        else
+        {
+            psStats->ui32RxDropped++;
+        }
+    }
+
+    if(ui32Count || ui16State)
+    {
+        g_pui32RxStaged[ui32Port] += ui32Count;
+        g_pui16RxState[ui32Port] |= ui16State;
+        psStats->ui32RxBytes += ui32Count;
+        ROM_IntPendSet(FAULT_PENDSV);
+    }
+}
+
+//*****************************************************************************
+//
+// Handles the interrupt of a bridged UART.
+//
+// \param ui32Port is the port the UART belongs to.
+//
+// The RX and receive timeout interrupts move the RX FIFO contents into the
+// USB transmit buffer and the TX interrupt refills the TX FIFO from the USB
+// receive buffer.  In uDMA mode the end of a TX transfer is signalled on this
+// interrupt as well.  USBUARTTxPump() makes it pending to start the refill.
+// This runs above the USB interrupt and leaves everything that needs usblib
+// to USBUARTDeferredIntHandler().
+//
+//*****************************************************************************
+static void UARTIntHandler(uint32_t ui32Port)
+{
+    uint32_t ui32Base, ui32Ints;
+
+    USBStackSample();
+    ui32Base = g_psUSBUARTPorts[ui32Port].ui32Base;
+    ui32Ints = ROM_UARTIntStatus(ui32Base, true);
+    ROM_UARTIntClear(ui32Base, ui32Ints);
+
+    if(ui32Ints & (UART_INT_RX | UART_INT_RT))
+    {
+        UARTRxDrain(ui32Port);
+    }
+
+#ifdef USB_UART_UDMA
+    if(g_pui32DMATxCount[ui32Port] &&
+       !ROM_uDMAChannelIsEnabled(g_psUSBUARTPorts[ui32Port].ui32DMAChannel))
+    {
+        g_pui32TxTaken[ui32Port] += g_pui32DMATxCount[ui32Port];
+        g_psUSBUARTStats[ui32Port].ui32TxBytes += g_pui32DMATxCount[ui32Port];
+        g_pui32DMATxCount[ui32Port] = 0;
+        ROM_IntPendSet(FAULT_PENDSV);
+    }
+#endif
+
+    UARTTxFill(ui32Port);
+}
+
+// Interrupt handlers for the UARTs of each port.  The vector of the UART
+// used by port n has to point at the matching handler in startup_ccs.c.
+void USBUARTIntHandler(void)
+{
+    UARTIntHandler(0);
+}
+
+void USBUARTPort1IntHandler(void)
+{
+#if USB_PORTS > 1
+    UARTIntHandler(1);
+#endif
+}
+
+void USBUARTPort2IntHandler(void)
+{
+#if USB_PORTS > 2
+    UARTIntHandler(2);
+#endif
+}
+
+// Let only the data already queued on a port reach its UART.  Anything the
+// host sends from now on stays in the receive buffer until the next call to
+// USBUARTConfigure().  Holding a port that is already held changes nothing.
+void USBUARTTxHold(uint32_t ui32Port)
+{
+    uint32_t ui32Mask;
+
+    ui32Mask = USBCriticalEnter();
+    if(!g_pbTxHeld[ui32Port])
+    {
+        // Some of the data still in the buffer may already have been handed
+        // to the UART.
+        g_pui32TxAllowance[ui32Port] =
+            USBBufferDataAvailable(&g_psRxBuffer[ui32Port]) -
+            g_pui32TxTaken[ui32Port];
+#ifdef USB_UART_UDMA
+        g_pui32TxAllowance[ui32Port] -= g_pui32DMATxCount[ui32Port];
+#endif
+        g_pbTxHeld[ui32Port] = true;
+    }
+    USBCriticalExit(ui32Mask);
+}
+
+// Return the number of bytes that still have to leave a port's UART with the
+// line coding currently in force, plus one while the transmitter is busy.
+// This is the answer to the CDC driver's USB_EVENT_DATA_REMAINING: zero means
+// everything the host sent under that coding is on the wire.
+uint32_t USBUARTTxRemaining(uint32_t ui32Port)
+{
+    uint32_t ui32Count, ui32Limit, ui32Mask;
+
+    ui32Mask = USBCriticalEnter();
+    ui32Count = USBBufferDataAvailable(&g_psRxBuffer[ui32Port]) -
+                g_pui32TxTaken[ui32Port];
+    if(g_pbTxHeld[ui32Port])
+    {
+        // The buffer may have been flushed since the port was held.
+        ui32Limit = g_pui32TxAllowance[ui32Port];
+#ifdef USB_UART_UDMA
+        ui32Limit += g_pui32DMATxCount[ui32Port];
+#endif
+        if(ui32Count > ui32Limit)
+        {
+            ui32Count = ui32Limit;
+        }
+    }
+    USBCriticalExit(ui32Mask);
+
+    return(ui32Count +
+           (ROM_UARTBusy(g_psUSBUARTPorts[ui32Port].ui32Base) ? 1 : 0));
+}
+
+// Apply a new rate and configuration word to a port's UART and release the
+// data held by USBUARTTxHold().  Reconfiguring the UART empties its FIFOs, so
+// whatever the peer has sent is moved to the host first; the caller makes
+// sure nothing is left to transmit.
+void USBUARTConfigure(uint32_t ui32Port, uint32_t ui32Rate,
+                      uint32_t ui32Config)
+{
+    uint32_t ui32Mask;
+
+    ui32Mask = USBCriticalEnter();
+    UARTRxDrain(ui32Port);
+    ROM_UARTConfigSetExpClk(g_psUSBUARTPorts[ui32Port].ui32Base,
+                            ROM_SysCtlClockGet(), ui32Rate, ui32Config);
+    g_pbTxHeld[ui32Port] = false;
+    USBCriticalExit(ui32Mask);
+
+    USBUARTTxPump(ui32Port);
+}
+
+// Return the number of bytes from a port's UART that are in its USB transmit
+// buffer but not yet committed by the deferred handler.
+uint32_t USBUARTRxStaged(uint32_t ui32Port)
+{
+    return(g_pui32RxStaged[ui32Port]);
+}
+
+// Forget what the UART interrupt has taken from or added to a port's USB
+// buffers once they have been flushed.  A uDMA transfer still reading the
+// receive buffer is stopped.  This must be called in a critical section.
+void USBUARTFlush(uint32_t ui32Port)
+{
+#ifdef USB_UART_UDMA
+    if(g_pui32DMATxCount[ui32Port])
+    {
+        ROM_uDMAChannelDisable(g_psUSBUARTPorts[ui32Port].ui32DMAChannel);
+        g_pui32DMATxCount[ui32Port] = 0;
+    }
+#endif
+    g_pui32TxTaken[ui32Port] = 0;
+    g_pui32RxStaged[ui32Port] = 0;
+    g_pui16RxState[ui32Port] = 0;
+    g_pui32TxAllowance[ui32Port] = 0;
+}
+
+//*****************************************************************************
+//
+// Finishes the work of the UART interrupts at the priority of the USB
+// interrupt.
+//
+// For each port the data the UART has sent is released from the USB receive
+// buffer, the data it has received is committed to the USB transmit buffer
+// and any line errors are reported to the host.  The UART interrupts make
+// this pending through PendSV, whose vector has to point here.
+//
+//*****************************************************************************
+void USBUARTDeferredIntHandler(void)
+{
+#ifdef USB_UART_BRIDGE
+    uint32_t ui32Port, ui32Taken, ui32Staged, ui32Mask;
+    uint16_t ui16State;
+
+    USBStackSample();
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        // The counts have to reach zero together with the buffer indices
+        // moving, or the UART interrupt would see the same bytes twice.
+        ui32Mask = USBCriticalEnter();
+        ui32Taken = g_pui32TxTaken[ui32Port];
+        USBRxConsume(&g_psRxBuffer[ui32Port], ui32Taken);
+        g_pui32TxTaken[ui32Port] = 0;
+        ui32Staged = g_pui32RxStaged[ui32Port];
+        USBTxCommit(&g_psTxBuffer[ui32Port], ui32Staged);
+        g_pui32RxStaged[ui32Port] = 0;
+        ui16State = g_pui16RxState[ui32Port];
+        g_pui16RxState[ui32Port] = 0;
+        USBCriticalExit(ui32Mask);
+
+        // A packet the full buffer had to leave in the FIFO can come in now
+        // rather than on the next frame, so that the UART does not run dry.
+        if(ui32Taken)
+        {
+            USBRxResume(ui32Port);
+        }
+        if(ui32Staged)
+        {
+            USBUARTFlowUpdate(ui32Port);
+        }
+        if(ui16State)
+        {
+            USBDCDCSerialStateChange((void *)&g_psCDCDevice[ui32Port],
+                                     ui16State);
+        }
+    }
+#endif
+}
+
+// Mirror the DTR and RTS state sent by the host with SET_CONTROL_LINE_STATE
+// onto the handshake pins of a port.
+void USBUARTControlLineSet(uint32_t ui32Port, uint16_t ui16State)
+{
+#ifdef USB_UART_FLOW_CONTROL
+    const tUSBUARTPort *psUART;
+
+    psUART = &g_psUSBUARTPorts[ui32Port];
+    ROM_GPIOPinWrite(psUART->ui32FlowBase, psUART->ui8DTRPin,
+                     (ui16State & USB_CDC_DTE_PRESENT) ? 0 : psUART->ui8DTRPin);
+    g_pbHostRTS[ui32Port] = (ui16State & USB_CDC_ACTIVATE_CARRIER) ? true :
+                            false;
+    FlowRTSSet(ui32Port);
+#endif
+}
+
+// Drop RTS when the buffer to the host is nearly full and raise it again once
+// it has drained to half full.  Called at the priority of the USB interrupt
+// whenever data is added to or sent from that buffer.
+void USBUARTFlowUpdate(uint32_t ui32Port)
+{
+#ifdef USB_UART_FLOW_CONTROL
+    uint32_t ui32Free;
+
+    ui32Free = USBBufferSpaceAvailable(&g_psTxBuffer[ui32Port]) -
+               g_pui32RxStaged[ui32Port];
+    if(!g_pbThrottled[ui32Port] && (ui32Free < USB_UART_FLOW_HEADROOM))
+    {
+        g_pbThrottled[ui32Port] = true;
+        g_psUSBUARTStats[ui32Port].ui32RxThrottles++;
+        FlowRTSSet(ui32Port);
+    }
+    else if(g_pbThrottled[ui32Port] &&
+            (ui32Free >= (g_psTxBuffer[ui32Port].ui32BufferSize / 2)))
+    {
+        g_pbThrottled[ui32Port] = false;
+        FlowRTSSet(ui32Port);
+    }
+#endif
+}
+
+//*****************************************************************************
+//
+// Interrupt handler for the CTS inputs.
+//
+// When a peer drops CTS the data to it is stopped: the TX interrupt is
+// turned off or, in uDMA mode, the transfer in flight is cut short and the
+// bytes that have not reached the FIFO are left in the receive buffer.  The
+// receive buffer then fills up and the OUT endpoint NAKs the host until the
+// peer raises CTS again and the pump is restarted.  Every port's CTS pin is
+// checked, so the vectors of all the GPIO ports used for CTS can point here.
+// This runs at the priority of the UART interrupts.
+//
+//*****************************************************************************
+void USBUARTFlowIntHandler(void)
+{
+#ifdef USB_UART_FLOW_CONTROL
+    const tUSBUARTPort *psUART;
+    uint32_t ui32Port;
+#ifdef USB_UART_UDMA
+    uint32_t ui32Done;
+#endif
+
+    USBStackSample();
+    for(ui32Port = 0; ui32Port < USB_PORTS; ui32Port++)
+    {
+        psUART = &g_psUSBUARTPorts[ui32Port];
+        if(!(GPIOIntStatus(psUART->ui32FlowBase, true) & psUART->ui8CTSPin))
+        {
+            continue;
+        }
+        GPIOIntClear(psUART->ui32FlowBase, psUART->ui8CTSPin);
+
+        if(FlowCTS(ui32Port))
+        {
+            UARTTxFill(ui32Port);
+            continue;
+        }
+
+        g_psUSBUARTStats[ui32Port].ui32TxStalls++;
+        USB_LOG(USB_LOG_CTS_STALL, ui32Port, 0);
+
+#ifdef USB_UART_UDMA
+        if(g_pui32DMATxCount[ui32Port])
+        {
+            ROM_uDMAChannelDisable(psUART->ui32DMAChannel);
+            ui32Done = g_pui32DMATxCount[ui32Port] -
+                       ROM_uDMAChannelSizeGet(psUART->ui32DMAChannel |
+                                              UDMA_PRI_SELECT);
+            g_pui32TxTaken[ui32Port] += ui32Done;
+            g_psUSBUARTStats[ui32Port].ui32TxBytes += ui32Done;
+            ROM_IntPendSet(FAULT_PENDSV);
+            if(g_pbTxHeld[ui32Port])
+            {
+                g_pui32TxAllowance[ui32Port] += g_pui32DMATxCount[ui32Port] -
+                                                ui32Done;
+            }
+            g_pui32DMATxCount[ui32Port] = 0;
+        }
+#else
+        ROM_UARTIntDisable(psUART->ui32Base, UART_INT_TX);
+#endif
+    }
+#endif
+}
@@ -0,0 +1,67 @@
+/*
+ * usbuart.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Lab
+ */
+
+#ifndef USBUART_H_
+#define USBUART_H_
+
+// Counters for the USB to UART bridge.  "Tx" is the host to UART direction
+// and "Rx" the UART to host direction, as seen from the UART.
+typedef struct
+{
+    uint32_t ui32TxBytes;
+    uint32_t ui32RxBytes;
+    uint32_t ui32RxOverruns;        // Characters lost in the UART RX FIFO.
+    uint32_t ui32RxFramingErrors;
+    uint32_t ui32RxParityErrors;
+    uint32_t ui32RxBreaks;
+    uint32_t ui32RxDropped;         // Lost because TxBuffer was full.
+    uint32_t ui32RxThrottles;       // Times RTS was dropped.
+    uint32_t ui32TxStalls;          // Times the peer dropped CTS.
+} tUSBUARTStats;
+
+// The hardware a port is bridged to: its UART and pins, the uDMA channel
+// feeding the UART TX FIFO and the GPIOs carrying the handshake lines.
+typedef struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32Periph;
+    uint32_t ui32Int;
+    uint32_t ui32GPIOPeriph;
+    uint32_t ui32GPIOBase;
+    uint32_t ui32GPIOPins;
+    uint32_t ui32RxPinConfig;
+    uint32_t ui32TxPinConfig;
+    uint32_t ui32DMAChannel;
+    uint32_t ui32DMAMap;
+    uint32_t ui32FlowPeriph;
+    uint32_t ui32FlowBase;
+    uint32_t ui32FlowInt;
+    uint8_t ui8RTSPin;
+    uint8_t ui8CTSPin;
+    uint8_t ui8DTRPin;
+} tUSBUARTPort;
+
+extern const tUSBUARTPort g_psUSBUARTPorts[USB_PORTS];
+extern tUSBUARTStats g_psUSBUARTStats[USB_PORTS];
+
+void USBUARTInit(void);
+void USBUARTTxPump(uint32_t ui32Port);
+void USBUARTIntHandler(void);
+void USBUARTPort1IntHandler(void);
+void USBUARTPort2IntHandler(void);
+void USBUARTTxHold(uint32_t ui32Port);
+uint32_t USBUARTTxRemaining(uint32_t ui32Port);
+void USBUARTConfigure(uint32_t ui32Port, uint32_t ui32Rate,
+                      uint32_t ui32Config);
+void USBUARTControlLineSet(uint32_t ui32Port, uint16_t ui16State);
+void USBUARTFlowUpdate(uint32_t ui32Port);
+void USBUARTFlowIntHandler(void);
+uint32_t USBUARTRxStaged(uint32_t ui32Port);
+void USBUARTFlush(uint32_t ui32Port);
+void USBUARTDeferredIntHandler(void);
+
+#endif /* USBUART_H_ */